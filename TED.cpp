@@ -1,9 +1,29 @@
 #include <tree.h>
+#include <corpus.h>
 #include <zhangShasha.h>
 #include <saeedScheme.h>
 #include <saeedSchemeOpt.h>
+#include <constrained.h>
+#include <shapes.h>
+#include <anchored.h>
+#include <anytime.h>
+#include <autoEngine.h>
+#include <boundedTed.h>
+#include <similarityJoin.h>
+#include <vpTree.h>
+#include <subtreeSearch.h>
+#include <incrementalTed.h>
+#include <batch.h>
+#include <oneToMany.h>
+#include <server.h>
+#include <shard.h>
+#include <parallel.h>
 #include <iostream>
+#include <fstream>
 #include <chrono>
+#include <limits>
+#include <algorithm>
+#include <cstdio>
 
 using namespace std::chrono;
 
@@ -11,12 +31,16 @@ int compute_ZhangShasha(const Tree& t1, const Tree& t2) {
     return ZhangShasha::ted(t1, t2);
 }
 
-int compute_SaeedScheme(const Tree& t1, const Tree& t2) {
-    return SaeedScheme::ted(t1, t2);
+int compute_SaeedScheme(const Tree& t1, const Tree& t2, int threads) {
+    return SaeedScheme::ted(t1, t2, threads);
 }
 
-int compute_SaeedSchemeOpt(const Tree& t1, const Tree&t2) {
-    return SaeedSchemeOpt::ted(t1, t2);
+int compute_SaeedSchemeOpt(const Tree& t1, const Tree&t2, int threads) {
+    return SaeedSchemeOpt::ted(t1, t2, threads);
+}
+
+int compute_Constrained(const Tree& t1, const Tree& t2) {
+    return Constrained::ted(t1, t2);
 }
 
 std::pair<std::string, std::string> get_input_trees() {
@@ -29,6 +53,634 @@ std::pair<std::string, std::string> get_input_trees() {
     return {t1_preorder, t2_preorder};
 }
 
+/**
+ * Reads a collection of trees from a file that contains the pre-order traversal of one tree per line.
+ * Empty lines are skipped.
+*/
+std::vector<Tree> read_trees(const std::string& path) {
+    std::ifstream in(path);
+    std::vector<Tree> trees;
+
+    std::string pre_order;
+    while (std::getline(in, pre_order)) {
+        if (!pre_order.empty() && pre_order.back() == '\r') {
+            pre_order.pop_back();
+        }
+
+        if (!pre_order.empty()) {
+            trees.push_back(Tree(pre_order));
+        }
+    }
+
+    return trees;
+}
+
+/**
+ * Reads a collection of trees like read_trees does, into a compact corpus that expands each tree on demand.
+*/
+Corpus read_corpus(const std::string& path) {
+    std::ifstream in(path);
+    Corpus corpus;
+
+    std::string pre_order;
+    while (std::getline(in, pre_order)) {
+        if (!pre_order.empty() && pre_order.back() == '\r') {
+            pre_order.pop_back();
+        }
+
+        if (!pre_order.empty()) {
+            corpus.add(pre_order);
+        }
+    }
+
+    corpus.shrink_to_fit();
+
+    return corpus;
+}
+
+/**
+ * Reads the optional trailing arguments of the modes that can be sharded, which are a number of threads
+ * and a shard given as "--shard i/N", in any order.
+ * 
+ * @returns False if an argument is not valid
+*/
+bool read_shard_options(int argc, char *argv[], int first, int& threads, Shard::Spec& shard, bool& sharded) {
+    for (int i = first; i < argc; ++i) {
+        std::string option(argv[i]);
+
+        if (option == "--shard") {
+            if (i + 1 >= argc || !Shard::parse(argv[++i], shard)) {
+                return false;
+            }
+
+            sharded = true;
+        } else {
+            threads = std::stoi(option);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * Computes an upper bound for the distance between two large and mostly similar trees by matching their
+ * identical subtrees first. See Anchored::ted.
+ * 
+ * Usage: Anchored [--verify]
+ * 
+ * The input is the same as for the exact algorithms. Prints the distance followed by "upper" since it is an
+ * upper bound. With --verify, the exact distance is computed as well and printed followed by "exact", and the
+ * gap to the upper bound is written to the standard error.
+*/
+int run_anchored(int argc, char *argv[]) {
+    bool verify = argc >= 3 && std::string(argv[2]) == "--verify";
+
+    auto start = high_resolution_clock::now();
+
+    const auto& input_trees = get_input_trees();
+
+    Tree t1(input_trees.first);
+    Tree t2(input_trees.second);
+
+    Anchored::Stats stats;
+    int d = Anchored::ted(t1, t2, stats);
+
+    auto stop = high_resolution_clock::now();
+
+    std::cerr << "Anchors: " << stats.anchors << std::endl;
+    std::cerr << "Matched: " << stats.matched << " / " << t1.n << std::endl;
+    std::cerr << "Residual: " << stats.residual1 << " x " << stats.residual2 << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    if (!verify) {
+        std::cout << d << " upper" << std::endl;
+        return 0;
+    }
+
+    int exact = compute_ZhangShasha(t1, t2);
+
+    std::cerr << "Upper bound: " << d << std::endl;
+    std::cerr << "Gap: " << d - exact << std::endl;
+
+    std::cout << exact << " exact" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Computes the exact distance between two trees whose tables may not fit in memory. See BoundedTed::ted.
+ * 
+ * Usage: Bounded [--max-memory size] [--scratch dir]
+ * 
+ * The input is the same as for the exact algorithms. The size accepts a suffix K, M or G. Tables that exceed it
+ * are backed by files created in the scratch directory, which defaults to /tmp. Prints the distance, and writes
+ * the size of the tables and whether they were spilled to the standard error.
+*/
+int run_bounded(int argc, char *argv[]) {
+    std::size_t max_memory = 0;
+    std::string scratch;
+
+    for (int i = 2; i < argc; i += 2) {
+        std::string option(argv[i]);
+
+        if (i + 1 >= argc) {
+            std::cerr << "Usage: Bounded [--max-memory size] [--scratch dir]" << std::endl;
+            return 1;
+        }
+
+        if (option == "--max-memory") {
+            if (!BoundedTed::parse_size(argv[i + 1], max_memory)) {
+                std::cerr << "Invalid size " << argv[i + 1] << std::endl;
+                return 1;
+            }
+        } else if (option == "--scratch") {
+            scratch = argv[i + 1];
+        } else {
+            std::cerr << "Usage: Bounded [--max-memory size] [--scratch dir]" << std::endl;
+            return 1;
+        }
+    }
+
+    auto start = high_resolution_clock::now();
+
+    const auto& input_trees = get_input_trees();
+
+    Tree t1(input_trees.first);
+    Tree t2(input_trees.second);
+
+    BoundedTed::Stats stats;
+    int d = BoundedTed::ted(t1, t2, max_memory, scratch, stats);
+
+    auto stop = high_resolution_clock::now();
+
+    std::cerr << "Subtree table: " << stats.td_bytes << " bytes" << (stats.td_spilled ? " on disk" : "") << std::endl;
+    std::cerr << "Forest rows: " << stats.fd_bytes << " bytes" << (stats.fd_spilled ? " on disk" : "") << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    std::cout << d << std::endl;
+
+    return 0;
+}
+
+/**
+ * Runs a similarity join between the collections of trees in two files.
+ * 
+ * Usage: Join <tau> <file A> <file B> [threads] [--shard i/N]
+ * 
+ * Prints one line "a b" for every pair within the threshold, where a and b are the zero-based positions of
+ * the trees in their files. Filtering statistics are written to the standard error.
+ * 
+ * With a shard, only the trees of A assigned to it are joined and the output ends with a line "# shard i/N"
+ * so that an interrupted shard can be told apart from a finished one.
+*/
+int run_join(int argc, char *argv[]) {
+    int threads = 0;
+    Shard::Spec shard;
+    bool sharded = false;
+
+    if (argc < 5 || !read_shard_options(argc, argv, 5, threads, shard, sharded)) {
+        std::cerr << "Usage: Join <tau> <file A> <file B> [threads] [--shard i/N]" << std::endl;
+        return 1;
+    }
+
+    auto start = high_resolution_clock::now();
+
+    int tau = std::stoi(argv[2]);
+
+    Corpus a = read_corpus(argv[3]);
+    Corpus b = read_corpus(argv[4]);
+
+    // Positions in A of the trees that are joined by this process
+    std::vector<int> rows(a.size());
+    for (int i = 0; i < a.size(); ++i) {
+        rows[i] = i;
+    }
+
+    if (sharded) {
+        // Every row is compared with all of B, so rows are balanced by their own cost alone
+        std::vector<long long> costs(a.size());
+        for (int i = 0; i < a.size(); ++i) {
+            costs[i] = Shard::cost(a.tree(i));
+        }
+
+        rows = Shard::rows(costs, shard);
+
+        Corpus subset;
+        for (int i: rows) {
+            subset.add(a.tree(i));
+        }
+
+        std::swap(a, subset);
+    }
+
+    SimilarityJoin::Stats stats;
+    std::vector<std::pair<int, int>> pairs = SimilarityJoin::join(a, b, tau, stats, threads);
+
+    auto stop = high_resolution_clock::now();
+
+    for (const auto& p: pairs) {
+        std::cout << rows[p.first] << " " << p.second << "\n";
+    }
+
+    if (sharded) {
+        std::cout << "# shard " << shard.index << "/" << shard.count << std::endl;
+    }
+
+    std::cerr << "Pairs: " << stats.pairs << std::endl;
+    std::cerr << "Candidates: " << stats.candidates << std::endl;
+    std::cerr << "Pruned: " << stats.pruned << std::endl;
+    std::cerr << "Accepted: " << stats.accepted << std::endl;
+    std::cerr << "Verified: " << stats.verified << std::endl;
+    std::cerr << "Matches: " << stats.matches << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Computes the distance between every pair of trees in a file.
+ * 
+ * Usage: AllPairs <file> [threads] [--shard i/N]
+ * 
+ * Prints one line "i j d" for every pair i < j, where i and j are the zero-based positions of the trees in the
+ * file and d is their distance. Rows of the matrix are split among shards by their estimated cost, and the
+ * output of a shard ends with a line "# shard i/N". The outputs of all shards can be combined with tools/merge.
+*/
+int run_all_pairs(int argc, char *argv[]) {
+    int threads = 0;
+    Shard::Spec shard;
+    bool sharded = false;
+
+    if (argc < 3 || !read_shard_options(argc, argv, 3, threads, shard, sharded)) {
+        std::cerr << "Usage: AllPairs <file> [threads] [--shard i/N]" << std::endl;
+        return 1;
+    }
+
+    auto start = high_resolution_clock::now();
+
+    std::vector<Tree> trees = read_trees(argv[2]);
+    int n = trees.size();
+
+    // Row i holds the pairs (i, j) for every j > i
+    std::vector<long long> costs(n);
+    long long suffix = 0;
+    for (int i = n - 1; i >= 0; --i) {
+        long long c = Shard::cost(trees[i]);
+        costs[i] = c * suffix;
+        suffix += c;
+    }
+
+    std::vector<int> rows = Shard::rows(costs, shard);
+    std::vector<std::vector<int>> distances(rows.size());
+
+    Parallel::for_each(rows.size(), [&](int x) {
+        int i = rows[x];
+
+        for (int j = i + 1; j < n; ++j) {
+            distances[x].push_back(ZhangShasha::ted(trees[i], trees[j]));
+        }
+    }, threads);
+
+    auto stop = high_resolution_clock::now();
+
+    long long pairs = 0;
+    for (int x = 0; x < rows.size(); ++x) {
+        for (int j = rows[x] + 1; j < n; ++j) {
+            std::cout << rows[x] << " " << j << " " << distances[x][j - rows[x] - 1] << "\n";
+            ++pairs;
+        }
+    }
+
+    if (sharded) {
+        std::cout << "# shard " << shard.index << "/" << shard.count << std::endl;
+    }
+
+    std::cerr << "Rows: " << rows.size() << std::endl;
+    std::cerr << "Pairs: " << pairs << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Builds and queries a metric index over a corpus of trees.
+ * 
+ * Usage:
+ * 
+ *      Index build <corpus file> <index file> [threads]
+ *      Index knn <index file> <k>
+ *      Index range <index file> <r>
+ * 
+ * Queries are read from the standard input, one tree per line. For every query, prints one line
+ * "q i d" for each result, where q is the zero-based position of the query, i is the position of the result in
+ * the corpus and d is its distance to the query. The number of distances computed for each query is written to
+ * the standard error.
+*/
+int run_index(int argc, char *argv[]) {
+    std::string command(argc >= 3 ? argv[2] : "");
+
+    if (command == "build" && argc >= 5) {
+        auto start = high_resolution_clock::now();
+
+        VPTree index(read_corpus(argv[3]), argc >= 6 ? std::stoi(argv[5]) : 0);
+
+        if (!index.save(argv[4])) {
+            std::cerr << "Unable to write index " << argv[4] << std::endl;
+            return 2;
+        }
+
+        auto stop = high_resolution_clock::now();
+
+        std::cerr << "Indexed: " << index.corpus.size() << std::endl;
+        std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+        return 0;
+    }
+
+    if ((command == "knn" || command == "range") && argc >= 5) {
+        VPTree index;
+
+        if (!index.load(argv[3])) {
+            std::cerr << "Unable to read index " << argv[3] << std::endl;
+            return 2;
+        }
+
+        int x = std::stoi(argv[4]);
+        long long total = 0;
+
+        std::string pre_order;
+        for (int q = 0; std::getline(std::cin, pre_order); ++q) {
+            if (!pre_order.empty() && pre_order.back() == '\r') {
+                pre_order.pop_back();
+            }
+
+            long long evaluations = 0;
+            Tree t(pre_order);
+
+            auto result = command == "knn" ? index.knn(t, x, evaluations) : index.range(t, x, evaluations);
+
+            for (const auto& r: result) {
+                std::cout << q << " " << r.second << " " << r.first << "\n";
+            }
+
+            std::cerr << "Query " << q << ": " << evaluations << " evaluations" << std::endl;
+            total += evaluations;
+        }
+
+        std::cerr << "Evaluations: " << total << std::endl;
+
+        return 0;
+    }
+
+    std::cerr << "Usage: Index build <corpus file> <index file> [threads]" << std::endl;
+    std::cerr << "       Index knn <index file> <k>" << std::endl;
+    std::cerr << "       Index range <index file> <r>" << std::endl;
+
+    return 1;
+}
+
+/**
+ * Finds the subtrees of a document closest to a query tree.
+ * 
+ * Usage: Subtree <k> [tau]
+ * 
+ * The first line of the input is the query tree and the second line is the document tree. If k is not positive,
+ * every subtree within distance tau is reported.
+ * 
+ * Results are streamed as they are found. A line "+ u d" means the subtree rooted at node u of the document is
+ * among the best ones found so far at distance d, and a line "- u d" means it was pushed out by a better one.
+*/
+int run_subtree(int argc, char *argv[]) {
+    if (argc < 3) {
+        std::cerr << "Usage: Subtree <k> [tau]" << std::endl;
+        return 1;
+    }
+
+    const auto& input_trees = get_input_trees();
+
+    Tree query(input_trees.first);
+    Tree document(input_trees.second);
+
+    int k = std::stoi(argv[2]);
+    int tau = argc >= 4 ? std::stoi(argv[3]) : std::numeric_limits<int>::max();
+
+    auto start = high_resolution_clock::now();
+
+    auto matches = SubtreeSearch::search(query, document, k, tau, [](const SubtreeSearch::Match& m, bool added) {
+        std::cout << (added ? "+ " : "- ") << m.node << " " << m.distance << std::endl;
+    });
+
+    auto stop = high_resolution_clock::now();
+
+    std::cerr << "Matches: " << matches.size() << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Computes the distance from a tree to successive versions of another tree, reusing the work done for the
+ * previous version.
+ * 
+ * Usage: Incremental
+ * 
+ * The first line of the input is T1 and every following line is a new version of T2. Prints the distance for
+ * every version. The number of reused and changed subtrees, and the share of the work that was done compared to
+ * a computation from scratch, are written to the standard error.
+*/
+int run_incremental(int argc, char *argv[]) {
+    std::string t1_preorder;
+    std::string t2_preorder;
+
+    std::getline(std::cin, t1_preorder);
+
+    if (!std::getline(std::cin, t2_preorder)) {
+        std::cerr << "Usage: Incremental < versions.in" << std::endl;
+        return 1;
+    }
+
+    IncrementalTED incremental((Tree(t1_preorder)), Tree(t2_preorder));
+
+    auto report = [&](int version) {
+        const auto& stats = incremental.stats;
+
+        std::cout << incremental.distance() << std::endl;
+        std::cerr << "Version " << version << ": "
+                  << stats.reused << " reused, "
+                  << stats.changed << " changed, "
+                  << stats.keyroots << " keyroots, "
+                  << stats.cells << " / " << stats.full_cells << " cells" << std::endl;
+    };
+
+    report(0);
+
+    for (int version = 1; std::getline(std::cin, t2_preorder); ++version) {
+        if (t2_preorder.empty()) {
+            continue;
+        }
+
+        incremental.update(Tree(t2_preorder));
+        report(version);
+    }
+
+    return 0;
+}
+
+/**
+ * Computes the distance of many pairs of small trees.
+ * 
+ * Usage: Batch [threads]
+ * 
+ * Every pair is given as two lines of the input, and the distance of every pair is printed on its own line in the
+ * same order. Pairs whose trees have the same shapes are computed together, one pair per SIMD lane. The number of
+ * pairs that were batched and that were computed one at a time is written to the standard error.
+*/
+int run_batch(int argc, char *argv[]) {
+    int threads = argc >= 3 ? std::stoi(argv[2]) : 0;
+
+    std::vector<std::pair<Tree, Tree>> pairs;
+    std::string t1_preorder;
+    std::string t2_preorder;
+
+    while (std::getline(std::cin, t1_preorder) && std::getline(std::cin, t2_preorder)) {
+        for (std::string* line: {&t1_preorder, &t2_preorder}) {
+            if (!line->empty() && line->back() == '\r') {
+                line->pop_back();
+            }
+        }
+
+        pairs.push_back({Tree(t1_preorder), Tree(t2_preorder)});
+    }
+
+    auto start = high_resolution_clock::now();
+
+    Batch::Stats stats;
+    std::vector<int> d = Batch::ted(pairs, stats, threads);
+
+    auto stop = high_resolution_clock::now();
+
+    for (int x: d) {
+        std::cout << x << "\n";
+    }
+
+    std::cerr << "Pairs: " << stats.pairs << std::endl;
+    std::cerr << "Batched: " << stats.batched << " in " << stats.batches << " batches" << std::endl;
+    std::cerr << "Scalar: " << stats.scalar << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Compares a query tree against every tree of a file, preparing the query only once.
+ * 
+ * Usage: OneToMany <candidates file> [--tau t] [--k k] [--threads n]
+ * 
+ * The query is the first line of the input. Prints one line "i d" for every candidate within distance tau of the
+ * query, or for every candidate if no threshold is given, where i is the zero-based line of the candidate in the file,
+ * counting empty lines even though they are skipped, and d is its distance. Lines follow the order of the file. With k,
+ * the file is no longer read once k matches are found. The number of candidates read, pruned and verified is written to
+ * the standard error.
+*/
+int run_one_to_many(int argc, char *argv[]) {
+    OneToMany::Options options;
+
+    bool valid = argc >= 3 && argc % 2 == 1;
+    for (int i = 3; valid && i + 1 < argc; i += 2) {
+        std::string option(argv[i]);
+
+        if (option == "--tau") {
+            options.tau = std::stoi(argv[i + 1]);
+        } else if (option == "--k") {
+            options.k = std::stoi(argv[i + 1]);
+        } else if (option == "--threads") {
+            options.threads = std::stoi(argv[i + 1]);
+        } else {
+            valid = false;
+        }
+    }
+
+    std::ifstream candidates(valid ? argv[2] : "");
+    std::string query;
+
+    if (!valid || !candidates || !std::getline(std::cin, query)) {
+        std::cerr << "Usage: OneToMany <candidates file> [--tau t] [--k k] [--threads n] < query.in" << std::endl;
+        return 1;
+    }
+
+    if (!query.empty() && query.back() == '\r') {
+        query.pop_back();
+    }
+
+    auto start = high_resolution_clock::now();
+
+    OneToMany::Query q((Tree(query)));
+    OneToMany::Stats stats;
+
+    OneToMany::run(q, candidates, options, stats, [](long long i, int d) {
+        std::cout << i << " " << d << "\n";
+    });
+
+    auto stop = high_resolution_clock::now();
+
+    std::cerr << "Candidates: " << stats.candidates << std::endl;
+    std::cerr << "Pruned: " << stats.pruned << std::endl;
+    std::cerr << "Verified: " << stats.verified << std::endl;
+    std::cerr << "Matches: " << stats.matches << (stats.stopped ? " (stopped early)" : "") << std::endl;
+    std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+    return 0;
+}
+
+/**
+ * Runs a long lived server that keeps a corpus of trees resident. See Server for the requests it understands.
+ * 
+ * Usage: Serve [--corpus <file>] [--socket <path>] [--threads <n>]
+ * 
+ * Trees in the corpus file are registered under their zero-based position in the file. Without a socket,
+ * requests are read from the standard input and responses are written to the standard output.
+*/
+int run_serve(int argc, char *argv[]) {
+    std::string corpus;
+    std::string socket;
+    int threads = 0;
+
+    for (int i = 2; i + 1 < argc; i += 2) {
+        std::string option(argv[i]);
+
+        if (option == "--corpus") {
+            corpus = argv[i + 1];
+        } else if (option == "--socket") {
+            socket = argv[i + 1];
+        } else if (option == "--threads") {
+            threads = std::stoi(argv[i + 1]);
+        }
+    }
+
+    Server server(threads);
+
+    if (!corpus.empty()) {
+        std::vector<Tree> trees = read_trees(corpus);
+
+        for (int i = 0; i < trees.size(); ++i) {
+            server.add(std::to_string(i), trees[i]);
+        }
+
+        std::cerr << "Registered: " << trees.size() << std::endl;
+    }
+
+    if (socket.empty()) {
+        return server.serve(0, 1);
+    }
+
+    if (server.listen(socket) != 0) {
+        std::cerr << "Unable to listen on " << socket << std::endl;
+        return 2;
+    }
+
+    return 0;
+}
+
 /**
  * 
  * Tree Edit Distance. Given two node-labeled rooted trees T and T' each of size at most n, what
@@ -54,10 +706,83 @@ int main(int argc, char *argv[]) {
      *      "Saeed"
      * 
      *          This will run an exact algorithm that uses a variant of the algorithm described in the paper
-     *          1+ϵ Approximation of Tree Edit Distance in Quadratic Time.
+     *          1+ϵ Approximation of Tree Edit Distance in Quadratic Time. Spine pairs that do not depend on
+     *          each other run in parallel, on as many threads as given by --threads n.
      * 
      *          Time complexity: O(n^6)
      * 
+     *      "Auto"
+     * 
+     *          This will count the work ZhangShasha takes when it decomposes both trees along their rightmost or
+     *          their leftmost paths, with T1 and T2 in either order, and run the cheapest one. The choice is
+     *          written to the standard error. See AutoEngine.
+     * 
+     *      "Constrained"
+     * 
+     *          This will compute the constrained edit distance described by Zhang in 1995, where disjoint
+     *          subtrees must be mapped to disjoint subtrees. It is an upper bound for the tree edit distance.
+     * 
+     *          Time complexity: O(n^2)
+     * 
+     *      "Anchored"
+     * 
+     *          This will match the identical subtrees of both trees first and run an exact algorithm on the rest,
+     *          which gives an upper bound for large and mostly similar trees. See run_anchored.
+     * 
+     *      "Bounded"
+     * 
+     *          This will run ZhangShasha within a memory budget, keeping only the forest rows that are still
+     *          needed and moving tables that do not fit to disk. See run_bounded.
+     * 
+     *      "Join"
+     * 
+     *          This will find every pair of trees from two collections whose distance is within a threshold.
+     *          The collections are read from files rather than from the standard input. See run_join.
+     * 
+     *      "AllPairs"
+     * 
+     *          This will compute the distance between every pair of trees in a file. The work can be split
+     *          among independent processes with a shard. See run_all_pairs.
+     * 
+     *      "Index"
+     * 
+     *          This will build a metric index over a corpus of trees, or answer nearest neighbor and range
+     *          queries with it. See run_index.
+     * 
+     *      "Subtree"
+     * 
+     *          This will find the subtrees of a large document tree that are closest to a small query tree.
+     *          See run_subtree.
+     * 
+     *      "Incremental"
+     * 
+     *          This will compute the distance from a tree to successive versions of another tree, only redoing
+     *          the work for the subtrees that changed between versions. See run_incremental.
+     * 
+     *      "Batch"
+     * 
+     *          This will compute the distance of many pairs of small trees, running pairs whose trees have the
+     *          same shapes together in SIMD lanes. See run_batch.
+     * 
+     *      "OneToMany"
+     * 
+     *          This will compare a query tree against every tree of a file, preparing the query only once, and
+     *          optionally stop after finding k trees within a threshold. See run_one_to_many.
+     * 
+     *      "Serve"
+     * 
+     *          This will start a long lived server that keeps a corpus of trees resident and answers requests
+     *          on a pool of threads. See run_serve.
+     * 
+     * The exact algorithms accept --deadline ms. When it passes, they print the best lower and upper bounds found
+     * so far followed by "bounded", such as "3 7 bounded". Otherwise they print the distance followed by "exact".
+     * 
+     * ZhangShasha, Saeed and SaeedOpt accept --checkpoint file [--every seconds] [--resume]. Their progress is
+     * written to the file every so many seconds, 60 unless told otherwise, and with --resume they continue from
+     * the checkpoint in the file, provided it was written by the same algorithm for the same trees. The file is
+     * removed once the distance is found. Checkpoints cannot be combined with --deadline. With --stop-after steps
+     * they write a checkpoint and stop once that many steps are done, and exit with 3 without printing a distance.
+     * 
      * The input should follow these rules.
      * 
      *      The input contains two trees T1 and T2 represented as strings that correspond
@@ -85,6 +810,102 @@ int main(int argc, char *argv[]) {
      * 
     */
 
+    if (argc >= 2 && std::string(argv[1]) == "Anchored") {
+        return run_anchored(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Bounded") {
+        return run_bounded(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Join") {
+        return run_join(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "AllPairs") {
+        return run_all_pairs(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Index") {
+        return run_index(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Subtree") {
+        return run_subtree(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Incremental") {
+        return run_incremental(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Batch") {
+        return run_batch(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "OneToMany") {
+        return run_one_to_many(argc, argv);
+    }
+
+    if (argc >= 2 && std::string(argv[1]) == "Serve") {
+        return run_serve(argc, argv);
+    }
+
+    std::string algorithm(argc <= 1 ? "ZhangShasha" : argv[1]);
+
+    // Saeed and SaeedOpt run independent spine pairs in parallel on every hardware thread unless told otherwise
+    int threads = 0;
+    // Milliseconds the exact algorithms may run for, or -1 for no limit
+    long long deadline = -1;
+    // File ZhangShasha, Saeed and SaeedOpt write their checkpoints to, or empty for none
+    std::string checkpoint;
+    // Seconds between two checkpoints
+    long long every = 60;
+    // Whether to continue from the checkpoint in the file
+    bool resume = false;
+    // Number of steps after which to write a checkpoint and stop, or -1 to run to the end
+    long long stop_after = -1;
+
+    for (int i = 2; i < argc; ++i) {
+        std::string option(argv[i]);
+
+        if (option == "--resume") {
+            resume = true;
+        } else if (i + 1 >= argc) {
+            break;
+        } else if (option == "--threads") {
+            threads = std::stoi(argv[i + 1]);
+        } else if (option == "--deadline") {
+            deadline = std::stoll(argv[i + 1]);
+        } else if (option == "--checkpoint") {
+            checkpoint = argv[i + 1];
+        } else if (option == "--every") {
+            every = std::stoll(argv[i + 1]);
+        } else if (option == "--stop-after") {
+            stop_after = std::stoll(argv[i + 1]);
+        }
+    }
+
+    if (resume && checkpoint.empty()) {
+        std::cerr << "Usage: --resume needs --checkpoint file" << std::endl;
+        return 1;
+    }
+
+    if (stop_after >= 0 && checkpoint.empty()) {
+        std::cerr << "Usage: --stop-after needs --checkpoint file" << std::endl;
+        return 1;
+    }
+
+    if (!checkpoint.empty() && algorithm != "ZhangShasha" && algorithm != "Saeed" && algorithm != "SaeedOpt") {
+        std::cerr << "Usage: only ZhangShasha, Saeed and SaeedOpt accept --checkpoint" << std::endl;
+        return 1;
+    }
+
+    // A checkpoint holds the table of a single exact algorithm, while a deadline races it against the heuristics
+    if (!checkpoint.empty() && deadline >= 0) {
+        std::cerr << "Usage: --deadline cannot be combined with --checkpoint" << std::endl;
+        return 1;
+    }
+
     auto start = high_resolution_clock::now();
 
     const auto& input_trees = get_input_trees();
@@ -92,16 +913,106 @@ int main(int argc, char *argv[]) {
     Tree t1(input_trees.first);
     Tree t2(input_trees.second);
 
-    std::string algorithm(argc <= 1 ? "ZhangShasha" : argv[1]);
+    if (!checkpoint.empty()) {
+        Checkpoints checkpoints(checkpoint, every);
+        checkpoints.limit = stop_after;
+
+        if (resume) {
+            Checkpoint& c = checkpoints.resume;
+
+            if (!c.load(checkpoint, algorithm, Checkpoint::hash(t1, t2))) {
+                std::cerr << "Unable to read checkpoint " << checkpoint << " written by " << algorithm << " for these trees" << std::endl;
+                return 1;
+            }
+
+            std::cerr << "Resumed: " << std::count(c.done.begin(), c.done.end(), true) << " / " << c.done.size() << " steps done" << std::endl;
+        }
+
+        int d = -1;
+
+        if (algorithm == "Saeed") {
+            d = SaeedScheme::ted(t1, t2, threads, CancelToken(), &checkpoints);
+        } else if (algorithm == "SaeedOpt") {
+            d = SaeedSchemeOpt::ted(t1, t2, threads, CancelToken(), &checkpoints);
+        } else if (!Shapes::ted(t1, t2, d)) {
+            d = ZhangShasha::ted(t1, t2, checkpoints);
+        }
+
+        auto stop = high_resolution_clock::now();
+
+        // The checkpoint is kept so that a later run can resume from it
+        if (checkpoints.stopped >= 0) {
+            std::cerr << "Stopped: " << checkpoints.stopped << " steps done" << std::endl;
+            return 3;
+        }
+
+        // The computation is done, so there is nothing left to resume
+        std::remove(checkpoint.c_str());
+
+        std::cout << d << std::endl;
+        std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+        return 0;
+    }
+
+    if (deadline >= 0 && algorithm != "Constrained") {
+        CancelToken token = CancelToken::after(deadline);
+        Anytime::Result r;
+
+        if (algorithm == "Saeed") {
+            r = Anytime::ted(t1, t2, token, [&](const Tree& a, const Tree& b, const CancelToken& t) {
+                return SaeedScheme::ted(a, b, threads, t);
+            });
+        } else if (algorithm == "SaeedOpt") {
+            r = Anytime::ted(t1, t2, token, [&](const Tree& a, const Tree& b, const CancelToken& t) {
+                return SaeedSchemeOpt::ted(a, b, threads, t);
+            });
+        } else if (algorithm == "Auto") {
+            AutoEngine::Plan plan = AutoEngine::choose(t1, t2);
+            std::cerr << "Engine: " << AutoEngine::name(plan) << std::endl;
+
+            r = Anytime::ted(t1, t2, token, [&](const Tree& a, const Tree& b, const CancelToken& t) {
+                return AutoEngine::ted(a, b, plan, t);
+            });
+        } else {
+            r = Anytime::ted(t1, t2, token);
+        }
+
+        auto stop = high_resolution_clock::now();
+
+        if (r.exact) {
+            std::cout << r.upper << " exact" << std::endl;
+        } else {
+            std::cout << r.lower << " " << r.upper << " bounded" << std::endl;
+        }
+
+        std::cerr << "Execution time: " << duration_cast<microseconds>(stop - start).count() << " microseconds" << std::endl;
+
+        return 0;
+    }
 
     int d = -1;
 
     if (algorithm == "ZhangShasha") {
-        d = compute_ZhangShasha(t1, t2);
+        // Paths and stars reduce to string edit distance, which gives the same result much faster
+        if (!Shapes::ted(t1, t2, d)) {
+            d = compute_ZhangShasha(t1, t2);
+        }
     } else if (algorithm == "Saeed") {
-        d = compute_SaeedScheme(t1, t2);
+        d = compute_SaeedScheme(t1, t2, threads);
     } else if (algorithm == "SaeedOpt") {
-        d = compute_SaeedSchemeOpt(t1, t2);
+        d = compute_SaeedSchemeOpt(t1, t2, threads);
+    } else if (algorithm == "Constrained") {
+        d = compute_Constrained(t1, t2);
+    } else if (algorithm == "Auto") {
+        for (const AutoEngine::Plan& plan: AutoEngine::plans(t1, t2)) {
+            std::cerr << "Estimated cost of " << AutoEngine::name(plan) << ": " << plan.cost << std::endl;
+        }
+
+        AutoEngine::Plan plan = AutoEngine::choose(t1, t2);
+        std::cerr << "Engine: " << AutoEngine::name(plan) << std::endl;
+
+        d = AutoEngine::ted(t1, t2, plan);
     }
 
     auto stop = high_resolution_clock::now();
@@ -0,0 +1,20 @@
+# Runs ted on a sample and compares its output with the expected one.
+#
+# Usage: cmake -DTED=<ted> -DALGORITHM=<name> -DINPUT=<file.in> -DEXPECTED=<file.out> -P compare.cmake
+
+execute_process(
+    COMMAND ${TED} ${ALGORITHM}
+    INPUT_FILE ${INPUT}
+    OUTPUT_VARIABLE actual
+    RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${ALGORITHM} exited with ${result} on ${INPUT}")
+endif()
+
+file(READ ${EXPECTED} expected)
+
+if(NOT actual STREQUAL expected)
+    message(FATAL_ERROR "${ALGORITHM} on ${INPUT} printed ${actual} but ${expected} was expected")
+endif()
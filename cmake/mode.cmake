@@ -0,0 +1,40 @@
+# Runs ted with the given arguments and compares its output with the expected one. What it writes to the standard
+# error can be compared too, leaving out the execution time.
+#
+# Arguments are separated by | since a ; would split them on the command line of the test.
+#
+# Usage: cmake -DTED=<ted> -DARGS=<a|b|...> [-DINPUT=<file.in>] -DEXPECTED=<file.out> [-DEXPECTED_LOG=<file.log>]
+#              -P mode.cmake
+
+string(REPLACE "|" ";" args "${ARGS}")
+
+if(INPUT)
+    set(input INPUT_FILE ${INPUT})
+endif()
+
+execute_process(
+    COMMAND ${TED} ${args}
+    ${input}
+    OUTPUT_VARIABLE actual
+    ERROR_VARIABLE log
+    RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${ARGS} exited with ${result}: ${log}")
+endif()
+
+file(READ ${EXPECTED} expected)
+
+if(NOT actual STREQUAL expected)
+    message(FATAL_ERROR "${ARGS} printed\n${actual}\nbut\n${expected}\nwas expected")
+endif()
+
+if(EXPECTED_LOG)
+    string(REGEX REPLACE "Execution time: [0-9]+ microseconds\n" "" log "${log}")
+    file(READ ${EXPECTED_LOG} expected)
+
+    if(NOT log STREQUAL expected)
+        message(FATAL_ERROR "${ARGS} reported\n${log}\nbut\n${expected}\nwas expected")
+    endif()
+endif()
@@ -0,0 +1,72 @@
+# Runs ted on a sample in parts that each stop after a number of steps and leave a checkpoint behind, resumes it
+# from the last checkpoint and compares its output with the expected one. A damaged checkpoint must be refused.
+#
+# Usage: cmake -DTED=<ted> -DALGORITHM=<name> -DINPUT=<file.in> -DEXPECTED=<file.out> -DCHECKPOINT=<file>
+#              -DSTEPS=<n|m|...> -P resume.cmake
+
+file(REMOVE ${CHECKPOINT} ${CHECKPOINT}.tmp)
+
+# The lengths after the magic read as about two billion, which must not be allocated
+file(WRITE ${CHECKPOINT} "TEDCKPT1zzzzzzzzzzzzzzzzzzzzzzzzzzzzzzzz")
+
+execute_process(
+    COMMAND ${TED} ${ALGORITHM} --checkpoint ${CHECKPOINT} --resume
+    INPUT_FILE ${INPUT}
+    OUTPUT_QUIET
+    ERROR_VARIABLE log
+    RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 1 OR NOT log MATCHES "Unable to read checkpoint")
+    message(FATAL_ERROR "${ALGORITHM} exited with ${result} on a damaged checkpoint: ${log}")
+endif()
+
+file(REMOVE ${CHECKPOINT})
+
+# Every part but the first resumes from the checkpoint of the one before
+string(REPLACE "|" ";" STEPS "${STEPS}")
+set(options)
+
+foreach(steps ${STEPS})
+    execute_process(
+        COMMAND ${TED} ${ALGORITHM} --threads 1 --checkpoint ${CHECKPOINT} --stop-after ${steps} ${options}
+        INPUT_FILE ${INPUT}
+        OUTPUT_QUIET
+        ERROR_VARIABLE log
+        RESULT_VARIABLE result
+    )
+
+    if(NOT result EQUAL 3 OR NOT EXISTS ${CHECKPOINT})
+        message(FATAL_ERROR "${ALGORITHM} did not stop after ${steps} steps on ${INPUT}: ${log}")
+    endif()
+
+    set(options --resume)
+endforeach()
+
+execute_process(
+    COMMAND ${TED} ${ALGORITHM} --checkpoint ${CHECKPOINT} --resume
+    INPUT_FILE ${INPUT}
+    OUTPUT_VARIABLE actual
+    ERROR_VARIABLE log
+    RESULT_VARIABLE result
+)
+
+file(REMOVE ${CHECKPOINT}.tmp)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "${ALGORITHM} exited with ${result} when resuming on ${INPUT}: ${log}")
+endif()
+
+if(NOT log MATCHES "Resumed: [1-9][0-9]* / ")
+    message(FATAL_ERROR "${ALGORITHM} did not resume from a checkpoint with steps done on ${INPUT}: ${log}")
+endif()
+
+if(EXISTS ${CHECKPOINT})
+    message(FATAL_ERROR "${ALGORITHM} left its checkpoint behind on ${INPUT}")
+endif()
+
+file(READ ${EXPECTED} expected)
+
+if(NOT actual STREQUAL expected)
+    message(FATAL_ERROR "${ALGORITHM} resumed on ${INPUT} printed ${actual} but ${expected} was expected")
+endif()
@@ -0,0 +1,35 @@
+# Pipes framed requests through ted Serve and compares the responses with the expected ones. Latencies reported by
+# STATS depend on the machine, so only the number of requests of each command is compared.
+#
+# Usage: cmake -DTED=<ted> -DCLIENT=<ted-client> -DINPUT=<requests> -DEXPECTED=<responses> [-DCORPUS=<file>]
+#              [-DTHREADS=<n>] -P serve.cmake
+
+set(options --threads ${THREADS})
+
+if(CORPUS)
+    list(APPEND options --corpus ${CORPUS})
+endif()
+
+execute_process(
+    COMMAND ${CLIENT} --encode
+    COMMAND ${TED} Serve ${options}
+    COMMAND ${CLIENT} --decode
+    INPUT_FILE ${INPUT}
+    OUTPUT_VARIABLE actual
+    ERROR_QUIET
+    RESULTS_VARIABLE results
+)
+
+foreach(result ${results})
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Serve exited with ${results} on ${INPUT}")
+    endif()
+endforeach()
+
+string(REGEX REPLACE " p50<[^\n]*| buckets=[^\n]*" "" actual "${actual}")
+
+file(READ ${EXPECTED} expected)
+
+if(NOT actual STREQUAL expected)
+    message(FATAL_ERROR "Serve on ${INPUT} answered\n${actual}\nbut\n${expected}\nwas expected")
+endif()
@@ -0,0 +1,48 @@
+# Runs ted on every shard of a Join or AllPairs run, combines the shards with ted-merge and compares the result
+# with the expected one.
+#
+# Arguments are separated by | since a ; would split them on the command line of the test.
+#
+# Usage: cmake -DTED=<ted> -DMERGE=<ted-merge> -DARGS=<a|b|...> -DSHARDS=<n> -DMERGE_ARGS=<a|b|...>
+#              -DWORK=<directory> -DEXPECTED=<file.out> -P shards.cmake
+
+string(REPLACE "|" ";" args "${ARGS}")
+string(REPLACE "|" ";" merge_args "${MERGE_ARGS}")
+
+file(MAKE_DIRECTORY ${WORK})
+
+set(files)
+math(EXPR last "${SHARDS} - 1")
+
+foreach(i RANGE ${last})
+    set(file ${WORK}/shard_${i}.out)
+    list(APPEND files ${file})
+
+    execute_process(
+        COMMAND ${TED} ${args} --shard ${i}/${SHARDS}
+        OUTPUT_FILE ${file}
+        ERROR_QUIET
+        RESULT_VARIABLE result
+    )
+
+    if(NOT result EQUAL 0)
+        message(FATAL_ERROR "Shard ${i}/${SHARDS} of ${ARGS} exited with ${result}")
+    endif()
+endforeach()
+
+execute_process(
+    COMMAND ${MERGE} ${merge_args} ${files}
+    OUTPUT_VARIABLE actual
+    ERROR_VARIABLE log
+    RESULT_VARIABLE result
+)
+
+if(NOT result EQUAL 0)
+    message(FATAL_ERROR "Merging the shards of ${ARGS} exited with ${result}: ${log}")
+endif()
+
+file(READ ${EXPECTED} expected)
+
+if(NOT actual STREQUAL expected)
+    message(FATAL_ERROR "The shards of ${ARGS} merged into\n${actual}\nbut\n${expected}\nwas expected")
+endif()
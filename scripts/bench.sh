@@ -0,0 +1,18 @@
+#!/bin/bash
+
+# Baseline to compare against, which is created on the first run
+baseline=${1:-bench.baseline}
+
+# Tolerance before a kernel is reported as a regression
+tolerance=${2:-0.1}
+
+# Build the ted-bench target of the CMake build, which is optimized unless told otherwise since the numbers are
+# meaningless without it
+cmake -S . -B build > /dev/null && cmake --build build --target ted-bench -j || exit 1
+
+if [ -f "$baseline" ]; then
+    ./build/ted-bench --baseline "$baseline" --tolerance "$tolerance"
+else
+    echo "Writing baseline to $baseline"
+    ./build/ted-bench --save "$baseline"
+fi
@@ -1,13 +1,13 @@
 #!/bin/bash
 
 # Declare collection of algorithms to run
-declare -a algos=("ZhangShasha" "Saeed" "SaeedOpt")
+declare -a algos=("ZhangShasha" "Saeed" "SaeedOpt" "Auto")
 
 total=0
 passed=0
 
 # Compile the app with g++
-g++ -o ted.exe -I./src/models -I./src/procedures *.cpp src/models/*.cpp src/procedures/*.cpp
+g++ -pthread -o ted.exe -I./src/models -I./src/procedures *.cpp src/models/*.cpp src/procedures/*.cpp
 
 # Loop through list of algorithms
 for algo in "${algos[@]}"; do
@@ -0,0 +1,148 @@
+#include <cted.h>
+#include <ted.h>
+#include <algorithm>
+#include <exception>
+#include <vector>
+
+/**
+ * The C handle is a heap allocated reference to the prepared tree of the C++ interface.
+*/
+struct ted_tree {
+    Ted::Handle handle;
+};
+
+/**
+ * The C token is a heap allocated reference to the token of the C++ interface.
+*/
+struct ted_token {
+    Ted::Token token;
+};
+
+ted_tree* ted_prepare(const char* pre_order) {
+    if (pre_order == nullptr) {
+        return nullptr;
+    }
+
+    try {
+        return new ted_tree{Ted::prepare(pre_order)};
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void ted_free(ted_tree* t) {
+    delete t;
+}
+
+int ted_size(const ted_tree* t) {
+    return t == nullptr ? -1 : Ted::size(t->handle);
+}
+
+int ted_distance(const ted_tree* t1, const ted_tree* t2) {
+    if (t1 == nullptr || t2 == nullptr) {
+        return -1;
+    }
+
+    try {
+        return Ted::distance(t1->handle, t2->handle);
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+int ted_within(const ted_tree* t1, const ted_tree* t2, int tau) {
+    if (t1 == nullptr || t2 == nullptr) {
+        return -1;
+    }
+
+    try {
+        return Ted::within(t1->handle, t2->handle, tau) ? 1 : 0;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+ted_token* ted_token_new(long long milliseconds) {
+    try {
+        return new ted_token{Ted::token(milliseconds)};
+    } catch (const std::exception&) {
+        return nullptr;
+    }
+}
+
+void ted_token_cancel(ted_token* token) {
+    if (token != nullptr) {
+        Ted::cancel(token->token);
+    }
+}
+
+void ted_token_free(ted_token* token) {
+    delete token;
+}
+
+int ted_distance_until(const ted_tree* t1, const ted_tree* t2, const ted_token* token, int* lower, int* upper) {
+    if (t1 == nullptr || t2 == nullptr || token == nullptr || lower == nullptr || upper == nullptr) {
+        return -1;
+    }
+
+    try {
+        Ted::Result r = Ted::distance(t1->handle, t2->handle, token->token);
+
+        *lower = r.lower;
+        *upper = r.upper;
+
+        return r.exact ? 1 : 0;
+    } catch (const std::exception&) {
+        return -1;
+    }
+}
+
+int ted_distances(const ted_tree* const* t1, const ted_tree* const* t2, int count, int* d, int threads) {
+    if (count < 0 || (count > 0 && (t1 == nullptr || t2 == nullptr || d == nullptr))) {
+        return -1;
+    }
+
+    std::vector<std::pair<Ted::Handle, Ted::Handle>> pairs(count);
+
+    for (int i = 0; i < count; ++i) {
+        if (t1[i] == nullptr || t2[i] == nullptr) {
+            return -1;
+        }
+
+        pairs[i] = {t1[i]->handle, t2[i]->handle};
+    }
+
+    try {
+        std::vector<int> result = Ted::distances(pairs, threads);
+        std::copy(result.begin(), result.end(), d);
+    } catch (const std::exception&) {
+        return -1;
+    }
+
+    return 0;
+}
+
+int ted_distances_to(const ted_tree* query, const ted_tree* const* candidates, int count, int* d, int threads) {
+    if (query == nullptr || count < 0 || (count > 0 && (candidates == nullptr || d == nullptr))) {
+        return -1;
+    }
+
+    std::vector<Ted::Handle> handles(count);
+
+    for (int i = 0; i < count; ++i) {
+        if (candidates[i] == nullptr) {
+            return -1;
+        }
+
+        handles[i] = candidates[i]->handle;
+    }
+
+    try {
+        std::vector<int> result = Ted::distances(query->handle, handles, threads);
+        std::copy(result.begin(), result.end(), d);
+    } catch (const std::exception&) {
+        return -1;
+    }
+
+    return 0;
+}
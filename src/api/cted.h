@@ -0,0 +1,108 @@
+#ifndef CTED_H
+#define CTED_H
+
+/*
+ * The C interface of libted, which keeps a stable ABI across releases of the library.
+ *
+ * Trees are prepared into opaque handles that must be released with ted_free. Handles are immutable, so they can
+ * be shared across threads. Functions never throw, and report errors through their return value instead.
+ */
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(_WIN32) && defined(TED_SHARED)
+#ifdef TED_EXPORTS
+#define TED_API __declspec(dllexport)
+#else
+#define TED_API __declspec(dllimport)
+#endif
+#elif defined(__GNUC__)
+#define TED_API __attribute__((visibility("default")))
+#else
+#define TED_API
+#endif
+
+/* A prepared tree. */
+typedef struct ted_tree ted_tree;
+
+/*
+ * Prepares a tree given its pre-order traversal, such as 1(2()3()).
+ *
+ * Returns a handle to the prepared tree, or NULL if the traversal is not valid.
+ */
+TED_API ted_tree* ted_prepare(const char* pre_order);
+
+/*
+ * Releases a prepared tree. Passing NULL does nothing.
+ */
+TED_API void ted_free(ted_tree* t);
+
+/*
+ * Gets the number of nodes of a prepared tree.
+ */
+TED_API int ted_size(const ted_tree* t);
+
+/*
+ * Computes the tree edit distance between two prepared trees with unit costs.
+ *
+ * Returns the distance, or -1 on failure.
+ */
+TED_API int ted_distance(const ted_tree* t1, const ted_tree* t2);
+
+/*
+ * Decides whether the tree edit distance between two prepared trees is at most tau.
+ *
+ * Returns 1 if it is, 0 if it is not, or -1 on failure.
+ */
+TED_API int ted_within(const ted_tree* t1, const ted_tree* t2, int tau);
+
+/* Tells a computation when to give up. */
+typedef struct ted_token ted_token;
+
+/*
+ * Creates a token that expires once the given number of milliseconds have passed, or only when cancelled if the
+ * number is negative. Returns NULL on failure.
+ */
+TED_API ted_token* ted_token_new(long long milliseconds);
+
+/*
+ * Expires a token. It is safe to call it from any thread while the token is in use.
+ */
+TED_API void ted_token_cancel(ted_token* token);
+
+/*
+ * Releases a token. Passing NULL does nothing.
+ */
+TED_API void ted_token_free(ted_token* token);
+
+/*
+ * Computes the tree edit distance between two prepared trees, giving up once the token expires. The distance, or
+ * the best bounds found by then, is written to lower and upper.
+ *
+ * Returns 1 if the distance is exact, 0 if only bounds were found, or -1 on failure.
+ */
+TED_API int ted_distance_until(const ted_tree* t1, const ted_tree* t2, const ted_token* token, int* lower, int* upper);
+
+/*
+ * Computes the tree edit distance of count pairs (t1[i], t2[i]) on a pool of threads, and writes them to d.
+ * If threads is not positive, all hardware threads are used.
+ *
+ * Returns 0 on success, or -1 on failure.
+ */
+TED_API int ted_distances(const ted_tree* const* t1, const ted_tree* const* t2, int count, int* d, int threads);
+
+/*
+ * Computes the tree edit distance from query to each of count candidates on a pool of threads, and writes them to
+ * d. If threads is not positive, all hardware threads are used.
+ *
+ * Returns 0 on success, or -1 on failure.
+ */
+TED_API int ted_distances_to(const ted_tree* query, const ted_tree* const* candidates, int count, int* d, int threads);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
@@ -0,0 +1,98 @@
+#include <ted.h>
+#include <tree.h>
+#include <preparedTree.h>
+#include <workspace.h>
+#include <zhangShasha.h>
+#include <constrained.h>
+#include <bounds.h>
+#include <shapes.h>
+#include <parallel.h>
+#include <anytime.h>
+#include <cancelToken.h>
+#include <stdexcept>
+
+/**
+ * A prepared tree along with its label histogram, which is all the library needs to compare it.
+*/
+struct Ted::Prepared {
+    PreparedTree prepared;
+    Bounds::Signature signature;
+};
+
+Ted::Handle Ted::prepare(const std::string& pre_order) {
+    if (!Tree::valid(pre_order)) {
+        throw std::invalid_argument("invalid pre-order traversal: " + pre_order);
+    }
+
+    Tree t(pre_order);
+
+    auto p = std::make_shared<Prepared>();
+    p->prepared = PreparedTree(t);
+    p->signature = Bounds::signature(t);
+
+    return p;
+}
+
+int Ted::size(const Handle& t) {
+    return t->prepared.tree.n;
+}
+
+int Ted::distance(const Handle& t1, const Handle& t2) {
+    int d = -1;
+
+    if (Shapes::ted(t1->prepared.tree, t2->prepared.tree, d)) {
+        return d;
+    }
+
+    return ZhangShasha::ted(t1->prepared, t2->prepared, Workspace::local());
+}
+
+bool Ted::within(const Handle& t1, const Handle& t2, int tau) {
+    if (Bounds::lower_bound(t1->signature, t2->signature) > tau) {
+        return false;
+    }
+
+    if (Constrained::ted(t1->prepared.tree, t2->prepared.tree) <= tau) {
+        return true;
+    }
+
+    return distance(t1, t2) <= tau;
+}
+
+Ted::Token Ted::token(long long milliseconds) {
+    if (milliseconds < 0) {
+        return std::make_shared<CancelToken>();
+    }
+
+    return std::make_shared<CancelToken>(CancelToken::after(milliseconds));
+}
+
+void Ted::cancel(const Token& token) {
+    token->cancel();
+}
+
+Ted::Result Ted::distance(const Handle& t1, const Handle& t2, const Token& token) {
+    Anytime::Result r = Anytime::ted(t1->prepared.tree, t2->prepared.tree, *token);
+
+    return Result{r.lower, r.upper, r.exact};
+}
+
+std::vector<int> Ted::distances(const std::vector<std::pair<Handle, Handle>>& pairs, int threads) {
+    std::vector<int> d(pairs.size());
+
+    Parallel::for_each(pairs.size(), [&](int i) {
+        d[i] = distance(pairs[i].first, pairs[i].second);
+    }, threads);
+
+    return d;
+}
+
+std::vector<int> Ted::distances(const Handle& query, const std::vector<Handle>& candidates, int threads) {
+    std::vector<int> d(candidates.size());
+
+    Parallel::for_each(candidates.size(), [&](int i) {
+        d[i] = distance(query, candidates[i]);
+    }, threads);
+
+    return d;
+}
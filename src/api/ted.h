@@ -0,0 +1,132 @@
+#ifndef TED_H
+#define TED_H
+
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+struct CancelToken;
+
+/**
+ * The public interface of libted, for programs that embed tree edit distance rather than running ted.exe.
+ *
+ * Trees are prepared once into an opaque handle that holds the tree along with every array the algorithms derive
+ * from it, and can then take part in any number of comparisons. Handles are immutable, so they can be shared
+ * across threads. None of the internal headers are needed to use this interface.
+*/
+namespace Ted {
+    struct Prepared;
+
+    /**
+     * A tree that is ready to be compared. Copies share the same prepared data.
+    */
+    typedef std::shared_ptr<const Prepared> Handle;
+
+    /**
+     * Prepares a tree given its pre-order traversal, such as 1(2()3()).
+     *
+     * It requires O(n) time.
+     *
+     * @param pre_order The pre-order traversal of the tree, with the children of every node enclosed in parenthesis
+     *
+     * @returns A handle to the prepared tree
+     *
+     * @throws std::invalid_argument if the traversal is not a single tree with integer labels and balanced
+     *         parenthesis
+    */
+    Handle prepare(const std::string& pre_order);
+
+    /**
+     * Gets the number of nodes of a prepared tree.
+    */
+    int size(const Handle& t);
+
+    /**
+     * Computes the tree edit distance between two prepared trees with unit costs.
+     *
+     * Paths and stars are solved as string edit distance, and every other pair with ZhangShasha.
+     *
+     * @param t1 A prepared tree
+     * @param t2 A prepared tree
+     *
+     * @returns The number of operations needed to transform t1 into t2
+    */
+    int distance(const Handle& t1, const Handle& t2);
+
+    /**
+     * Decides whether the tree edit distance between two prepared trees is at most tau.
+     *
+     * The label histogram lower bound rejects a pair and the constrained distance accepts it before the exact
+     * distance is computed, so this is usually much faster than comparing the result of distance.
+     *
+     * @param t1 A prepared tree
+     * @param t2 A prepared tree
+     * @param tau The largest distance allowed
+     *
+     * @returns Whether the tree edit distance between t1 and t2 is at most tau
+    */
+    bool within(const Handle& t1, const Handle& t2, int tau);
+
+    /**
+     * Tells a computation when to give up. It can be cancelled from any thread.
+    */
+    typedef std::shared_ptr<CancelToken> Token;
+
+    /**
+     * Creates a token that expires once the given number of milliseconds have passed, or only when cancelled if
+     * the number is negative.
+    */
+    Token token(long long milliseconds = -1);
+
+    /**
+     * Expires a token, so that every computation that uses it gives up at its next check.
+    */
+    void cancel(const Token& token);
+
+    /**
+     * The distance between two trees, or the range it lies in if the computation gave up.
+    */
+    struct Result {
+        int lower;
+        int upper;
+        // Whether lower and upper are both the tree edit distance.
+        bool exact;
+    };
+
+    /**
+     * Computes the tree edit distance between two prepared trees like distance does, but gives up once the token
+     * expires. The best bounds found by then are returned: the label histogram lower bound, and the constrained
+     * edit distance as an upper bound if there was time to compute it.
+     *
+     * @param t1 A prepared tree
+     * @param t2 A prepared tree
+     * @param token The token that tells when to give up
+     *
+     * @returns The distance, or bounds for it
+    */
+    Result distance(const Handle& t1, const Handle& t2, const Token& token);
+
+    /**
+     * Computes the tree edit distance of many pairs of prepared trees on a pool of threads.
+     *
+     * @param pairs The pairs of trees to compare
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     *
+     * @returns The distance of every pair, in the same order
+    */
+    std::vector<int> distances(const std::vector<std::pair<Handle, Handle>>& pairs, int threads = 0);
+
+    /**
+     * Computes the tree edit distance from one prepared tree to many others on a pool of threads.
+     *
+     * @param query The tree every candidate is compared to
+     * @param candidates The trees to compare to the query
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     *
+     * @returns The distance from the query to every candidate, in the same order
+    */
+    std::vector<int> distances(const Handle& query, const std::vector<Handle>& candidates, int threads = 0);
+}
+
+#endif
@@ -0,0 +1,35 @@
+#include <cancelToken.h>
+
+CancelToken::CancelToken() : stopped(false), timed(false) {
+}
+
+CancelToken::CancelToken(Clock::time_point deadline) : stopped(false), timed(true), deadline(deadline) {
+}
+
+CancelToken CancelToken::after(long long milliseconds) {
+    return CancelToken(Clock::now() + std::chrono::milliseconds(milliseconds));
+}
+
+CancelToken::CancelToken(const CancelToken& other) : stopped(other.stopped.load()), timed(other.timed), deadline(other.deadline) {
+}
+
+void CancelToken::cancel() {
+    stopped = true;
+}
+
+bool CancelToken::expired() const {
+    if (stopped.load(std::memory_order_relaxed)) {
+        return true;
+    }
+
+    if (timed && Clock::now() >= deadline) {
+        stopped = true;
+        return true;
+    }
+
+    return false;
+}
+
+bool CancelToken::cancelled() const {
+    return stopped.load(std::memory_order_relaxed);
+}
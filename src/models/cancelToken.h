@@ -0,0 +1,56 @@
+#ifndef CANCELTOKEN_H
+#define CANCELTOKEN_H
+
+#include <atomic>
+#include <chrono>
+
+/**
+ * Tells a long running computation that it should stop, either because its deadline passed or because it was
+ * cancelled from another thread.
+ *
+ * Computations check the token between units of work, such as pairs of keyroots or pairs of spines, and return as
+ * soon as they find it expired. Once a token expires it stays expired.
+*/
+struct CancelToken {
+    typedef std::chrono::steady_clock Clock;
+
+    /**
+     * Constructs a token without a deadline, which only expires when cancelled.
+    */
+    CancelToken();
+
+    /**
+     * Constructs a token that expires at the given time.
+    */
+    CancelToken(Clock::time_point deadline);
+
+    /**
+     * Constructs a token that expires once the given number of milliseconds have passed.
+    */
+    static CancelToken after(long long milliseconds);
+
+    CancelToken(const CancelToken& other);
+
+    /**
+     * Expires the token. It is safe to call it from any thread.
+    */
+    void cancel();
+
+    /**
+     * Checks whether the token was cancelled or its deadline passed. It reads the clock, so computations call it
+     * every so often rather than for every cell.
+    */
+    bool expired() const;
+
+    /**
+     * Checks whether the token was found expired before, without reading the clock.
+    */
+    bool cancelled() const;
+
+private:
+    mutable std::atomic<bool> stopped;
+    bool timed;
+    Clock::time_point deadline;
+};
+
+#endif
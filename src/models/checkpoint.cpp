@@ -0,0 +1,189 @@
+#include <checkpoint.h>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+
+// Identifies files written by Checkpoint::save
+static const char MAGIC[8] = {'T', 'E', 'D', 'C', 'K', 'P', 'T', '1'};
+
+long long Checkpoint::first() const {
+    return std::find(done.begin(), done.end(), false) - done.begin();
+}
+
+bool Checkpoint::save(const std::string& path) const {
+    std::string temporary = path + ".tmp";
+
+    {
+        std::ofstream out(temporary, std::ios::binary);
+
+        if (!out) {
+            return false;
+        }
+
+        auto write = [&](auto x) {
+            out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+        };
+
+        out.write(MAGIC, sizeof(MAGIC));
+
+        write(static_cast<std::int32_t>(algorithm.size()));
+        out.write(algorithm.data(), algorithm.size());
+
+        write(inputs);
+        write(static_cast<std::int32_t>(rows));
+        write(static_cast<std::int32_t>(cols));
+
+        write(static_cast<std::int64_t>(done.size()));
+        for (std::size_t w = 0; w < done.size(); w += 64) {
+            std::uint64_t word = 0;
+
+            for (std::size_t b = 0; b < 64 && w + b < done.size(); ++b) {
+                word |= static_cast<std::uint64_t>(done[w + b]) << b;
+            }
+
+            write(word);
+        }
+
+        // Distances rarely need more than one or two bytes
+        std::uint8_t width = 1;
+        for (int cell: td) {
+            if (cell < 0 || cell > 0xffff) {
+                width = 4;
+                break;
+            }
+
+            if (cell > 0xff) {
+                width = 2;
+            }
+        }
+
+        write(width);
+        for (int cell: td) {
+            if (width == 1) {
+                write(static_cast<std::uint8_t>(cell));
+            } else if (width == 2) {
+                write(static_cast<std::uint16_t>(cell));
+            } else {
+                write(static_cast<std::int32_t>(cell));
+            }
+        }
+
+        if (!out.flush()) {
+            return false;
+        }
+    }
+
+    return std::rename(temporary.c_str(), path.c_str()) == 0;
+}
+
+bool Checkpoint::load(const std::string& path, const std::string& expected_algorithm, std::uint64_t expected_inputs) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+
+    // Every length read from the file is checked against the bytes left in it before anything is allocated, so
+    // that a damaged file cannot ask for more memory than its own size
+    std::streamoff size = in.tellg();
+    in.seekg(0);
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+        return false;
+    }
+
+    auto read = [&](auto x) {
+        in.read(reinterpret_cast<char*>(&x), sizeof(x));
+        return x;
+    };
+
+    // Checks that a number of bytes fits in the rest of the file
+    auto fits = [&](std::int64_t bytes) {
+        return in && bytes >= 0 && bytes <= size - static_cast<std::streamoff>(in.tellg());
+    };
+
+    std::int32_t length = read(std::int32_t(0));
+    if (!fits(length)) {
+        return false;
+    }
+
+    algorithm.assign(length, '\0');
+    in.read(&algorithm[0], algorithm.size());
+
+    inputs = read(std::uint64_t(0));
+    rows = read(std::int32_t(0));
+    cols = read(std::int32_t(0));
+
+    // A checkpoint of another computation is refused before its table is read
+    if (!in || algorithm != expected_algorithm || inputs != expected_inputs || rows < 0 || cols < 0) {
+        return false;
+    }
+
+    std::int64_t steps = read(std::int64_t(0));
+    if (steps < 0 || !fits((steps + 63) / 64 * sizeof(std::uint64_t))) {
+        return false;
+    }
+
+    done.assign(steps, false);
+    for (std::size_t w = 0; w < done.size(); w += 64) {
+        std::uint64_t word = read(std::uint64_t(0));
+
+        for (std::size_t b = 0; b < 64 && w + b < done.size(); ++b) {
+            done[w + b] = (word >> b) & 1;
+        }
+    }
+
+    std::uint8_t width = read(std::uint8_t(0));
+    std::int64_t cells = static_cast<std::int64_t>(rows) * cols;
+
+    if ((width != 1 && width != 2 && width != 4) || !fits(cells * width)) {
+        return false;
+    }
+
+    td.assign(cells, 0);
+    for (std::size_t c = 0; c < td.size() && in; ++c) {
+        if (width == 1) {
+            td[c] = read(std::uint8_t(0));
+        } else if (width == 2) {
+            td[c] = read(std::uint16_t(0));
+        } else {
+            td[c] = read(std::int32_t(0));
+        }
+    }
+
+    return static_cast<bool>(in);
+}
+
+std::uint64_t Checkpoint::hash(const Tree& t1, const Tree& t2) {
+    std::uint64_t h = 14695981039346656037ULL;
+
+    auto mix = [&](std::int64_t x) {
+        for (int b = 0; b < 8; ++b) {
+            h ^= (x >> (8 * b)) & 0xff;
+            h *= 1099511628211ULL;
+        }
+    };
+
+    for (const Tree* t: {&t1, &t2}) {
+        mix(t->n);
+
+        for (int u = 1; u <= t->n; ++u) {
+            mix(t->labels[u]);
+            mix(t->parent[u]);
+        }
+    }
+
+    return h;
+}
+
+Checkpoints::Checkpoints(const std::string& path, long long seconds)
+    : path(path), interval(std::chrono::seconds(seconds)), last(Clock::now()) {
+}
+
+bool Checkpoints::due() const {
+    return Clock::now() - last >= interval;
+}
+
+bool Checkpoints::save(const Checkpoint& c) {
+    bool saved = c.save(path);
+    last = Clock::now();
+
+    return saved;
+}
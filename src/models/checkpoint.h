@@ -0,0 +1,103 @@
+#ifndef CHECKPOINT_H
+#define CHECKPOINT_H
+
+#include <tree.h>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * The state of an exact computation that can be written to a file and continued later.
+ *
+ * Exact algorithms fill a table of tree edit distances in a fixed sequence of steps, such as pairs of keyroots
+ * or pairs of spines. A checkpoint keeps the table along with the steps that are done, so that a computation
+ * that is resumed from it only does the remaining ones.
+*/
+struct Checkpoint {
+    // Name of the algorithm that wrote the checkpoint.
+    std::string algorithm;
+    // Hash of the trees the algorithm was run on. See hash.
+    std::uint64_t inputs = 0;
+    // Number of rows of the table.
+    int rows = 0;
+    // Number of columns of the table.
+    int cols = 0;
+    // Cells of the table in row-major order.
+    std::vector<int> td;
+    // Whether each step is done.
+    std::vector<bool> done;
+
+    /**
+     * Gets the first step that is not done, or the number of steps if every step is.
+    */
+    long long first() const;
+
+    /**
+     * Writes the checkpoint to a file. It is written to a temporary file first and renamed, so that the file
+     * always holds a complete checkpoint even if the process is killed while writing it.
+     *
+     * Cells are stored with the fewest bytes that hold the largest of them, and steps as a bitmap.
+     *
+     * @returns Whether the checkpoint was written
+    */
+    bool save(const std::string& path) const;
+
+    /**
+     * Reads a checkpoint written by save for the given algorithm and inputs. The header is checked before the
+     * steps and cells are read, and their lengths against the size of the file, so a damaged file or one written
+     * for another computation is refused without allocating its table.
+     *
+     * @returns Whether a complete checkpoint of the given algorithm and inputs was read
+    */
+    bool load(const std::string& path, const std::string& expected_algorithm, std::uint64_t expected_inputs);
+
+    /**
+     * Computes a 64-bit FNV-1a hash of the labels and parents of both trees, which tells whether a checkpoint was
+     * written for the same inputs.
+    */
+    static std::uint64_t hash(const Tree& t1, const Tree& t2);
+};
+
+/**
+ * Writes checkpoints of a computation to a file every so often, and holds the checkpoint it continues from.
+*/
+struct Checkpoints {
+    typedef std::chrono::steady_clock Clock;
+
+    // File every checkpoint is written to.
+    std::string path;
+    // Time between two checkpoints.
+    Clock::duration interval;
+    // Checkpoint the computation continues from. It has no cells when the computation starts from scratch.
+    Checkpoint resume;
+    // Number of steps after which the computation writes a checkpoint and stops, or -1 to run to the end. The
+    // computation stops at the first chance it gets once that many steps are done, which is the same for the same
+    // trees, so a run can be split into parts of a known size.
+    long long limit = -1;
+    // Number of steps done when the computation stopped at the limit, or -1 if it did not stop.
+    long long stopped = -1;
+
+    /**
+     * Constructs a schedule that writes a checkpoint to the given file once the given number of seconds have
+     * passed since the last one.
+    */
+    Checkpoints(const std::string& path, long long seconds);
+
+    /**
+     * Checks whether the interval has passed since the last checkpoint was written.
+    */
+    bool due() const;
+
+    /**
+     * Writes a checkpoint and starts the interval again.
+     *
+     * @returns Whether the checkpoint was written
+    */
+    bool save(const Checkpoint& c);
+
+private:
+    Clock::time_point last;
+};
+
+#endif
@@ -0,0 +1,215 @@
+#include <corpus.h>
+#include <utility>
+
+Corpus::Corpus() {
+    width = 1;
+    bits = 0;
+    offsets.push_back(0);
+}
+
+int Corpus::size() const {
+    return offsets.size() - 1;
+}
+
+bool Corpus::empty() const {
+    return size() == 0;
+}
+
+int Corpus::nodes(int i) const {
+    return offsets[i + 1] - offsets[i];
+}
+
+void Corpus::push_paren(bool opening) {
+    if (bits % 64 == 0) {
+        shape.push_back(0);
+    }
+
+    if (opening) {
+        shape.back() |= std::uint64_t(1) << (bits % 64);
+    }
+
+    ++bits;
+}
+
+void Corpus::push_label(int label) {
+    std::uint64_t z = (static_cast<std::uint32_t>(label) << 1) ^ static_cast<std::uint32_t>(label >> 31);
+    std::uint64_t count = offsets.back();
+
+    if (z >> width) {
+        // The label does not fit, so every label stored so far is packed again with the new width. The width
+        // only grows up to 32 times, so this takes amortized constant time per label.
+        int wider = width;
+        while (z >> wider) {
+            ++wider;
+        }
+
+        std::vector<std::uint64_t> labels(count);
+        for (std::uint64_t x = 0; x < count; ++x) {
+            labels[x] = static_cast<std::uint32_t>(label_bits(x));
+        }
+
+        width = wider;
+        packed.assign((count * width + 63) / 64, 0);
+
+        for (std::uint64_t x = 0; x < count; ++x) {
+            put(x, labels[x]);
+        }
+    }
+
+    std::uint64_t end = (count + 1) * width;
+    if (packed.size() * 64 < end) {
+        packed.push_back(0);
+    }
+
+    put(count, z);
+    ++offsets.back();
+}
+
+std::uint64_t Corpus::label_bits(std::uint64_t node) const {
+    std::uint64_t pos = node * width;
+    std::uint64_t word = pos / 64;
+    int shift = pos % 64;
+
+    std::uint64_t z = packed[word] >> shift;
+    if (shift + width > 64) {
+        z |= packed[word + 1] << (64 - shift);
+    }
+
+    return z & ((std::uint64_t(1) << width) - 1);
+}
+
+void Corpus::put(std::uint64_t node, std::uint64_t z) {
+    std::uint64_t pos = node * width;
+    std::uint64_t word = pos / 64;
+    int shift = pos % 64;
+
+    packed[word] |= z << shift;
+    if (shift + width > 64) {
+        packed[word + 1] |= z >> (64 - shift);
+    }
+}
+
+int Corpus::label(std::uint64_t node) const {
+    std::uint64_t z = label_bits(node);
+
+    return static_cast<int>(static_cast<std::uint32_t>(z >> 1) ^ -static_cast<std::uint32_t>(z & 1));
+}
+
+void Corpus::add(const Tree& t) {
+    offsets.push_back(offsets.back());
+
+    if (t.n == 0) {
+        return;
+    }
+
+    // Nodes are visited in pre-order, along with the position of the next child to visit
+    std::vector<std::pair<int, int>> stack;
+
+    for (int r: t.adj[0]) {
+        stack.push_back({r, 0});
+        push_paren(true);
+        push_label(t.labels[r]);
+
+        while (!stack.empty()) {
+            auto& [u, next] = stack.back();
+
+            if (next == t.adj[u].size()) {
+                push_paren(false);
+                stack.pop_back();
+                continue;
+            }
+
+            int v = t.adj[u][next++];
+
+            stack.push_back({v, 0});
+            push_paren(true);
+            push_label(t.labels[v]);
+        }
+    }
+}
+
+void Corpus::add(const std::string& pre_order) {
+    offsets.push_back(offsets.back());
+
+    for (int i = 0; i < pre_order.size();) {
+        char c = pre_order[i];
+
+        if (c == '(') {
+            ++i;
+        } else if (c == ')') {
+            push_paren(false);
+            ++i;
+        } else {
+            int j = i;
+            while (j < pre_order.size() && pre_order[j] != '(' && pre_order[j] != ')') {
+                ++j;
+            }
+
+            push_paren(true);
+            push_label(std::stoi(pre_order.substr(i, j - i)));
+            i = j;
+        }
+    }
+}
+
+Tree Corpus::tree(int i) const {
+    Tree t;
+
+    int n = nodes(i);
+    if (n == 0) {
+        return t;
+    }
+
+    t.n = n;
+    t.root = 1;
+    t.adj = std::vector<std::vector<int>>(n + 1);
+    t.parent = std::vector<int>(n + 1);
+    t.labels = std::vector<int>(n + 1);
+
+    std::uint64_t first = offsets[i];
+    std::uint64_t pos = 2 * first;
+    std::uint64_t end = 2 * offsets[i + 1];
+
+    int u = 0, idx = 1;
+
+    for (; pos < end; ++pos) {
+        if ((shape[pos / 64] >> (pos % 64)) & 1) {
+            t.adj[u].push_back(idx);
+            t.parent[idx] = u;
+            t.labels[idx] = label(first + idx - 1);
+            u = idx++;
+        } else {
+            u = t.parent[u];
+        }
+    }
+
+    return t;
+}
+
+std::string Corpus::pre_order(int i) const {
+    std::string s;
+
+    std::uint64_t node = offsets[i];
+    std::uint64_t end = 2 * offsets[i + 1];
+
+    for (std::uint64_t pos = 2 * offsets[i]; pos < end; ++pos) {
+        if ((shape[pos / 64] >> (pos % 64)) & 1) {
+            s += std::to_string(label(node++));
+            s += '(';
+        } else {
+            s += ')';
+        }
+    }
+
+    return s;
+}
+
+std::size_t Corpus::bytes() const {
+    return (shape.capacity() + packed.capacity() + offsets.capacity()) * sizeof(std::uint64_t);
+}
+
+void Corpus::shrink_to_fit() {
+    shape.shrink_to_fit();
+    packed.shrink_to_fit();
+    offsets.shrink_to_fit();
+}
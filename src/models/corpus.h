@@ -0,0 +1,97 @@
+#ifndef CORPUS_H
+#define CORPUS_H
+
+#include <tree.h>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <cstddef>
+
+/**
+ * A compact store for a large collection of trees, such as the corpus of a similarity join or of a nearest neighbor
+ * index.
+ *
+ * A Tree keeps several vectors per node, which for small trees takes far more memory than the data itself. Here every
+ * tree is kept as its balanced parentheses, that is one bit per parenthesis of its pre-order traversal, along with its
+ * labels in pre-order packed into as few bits as the largest label needs. Trees share one buffer for the parentheses
+ * and one for the labels, and an offset table tells where each one starts, so a tree of n nodes takes about
+ * 2n + wn + 64 bits where w is the width of a label.
+ *
+ * Trees are expanded into a Tree on demand, which takes linear time in their number of nodes.
+*/
+struct Corpus {
+    // Parentheses of every tree, one after the other. An opening parenthesis is a one bit, and a closing one a zero.
+    std::vector<std::uint64_t> shape;
+    // Labels of every node in pre-order, zigzag encoded so small negative labels stay small, width bits each.
+    std::vector<std::uint64_t> packed;
+    // Number of bits of every packed label.
+    int width;
+    // offsets[i] is the number of nodes before tree i. It has one more entry than there are trees.
+    std::vector<std::uint64_t> offsets;
+
+    /**
+     * Constructs an empty corpus.
+    */
+    Corpus();
+
+    /**
+     * Gets the number of trees in the corpus.
+    */
+    int size() const;
+
+    /**
+     * Whether the corpus has no trees.
+    */
+    bool empty() const;
+
+    /**
+     * Gets the number of nodes of the i-th tree.
+    */
+    int nodes(int i) const;
+
+    /**
+     * Appends a tree to the corpus.
+     *
+     * It requires O(n) amortized time where n is the number of nodes of the tree.
+    */
+    void add(const Tree& t);
+
+    /**
+     * Appends a tree given its pre-order traversal, such as 1(2()3()), without building a Tree first.
+    */
+    void add(const std::string& pre_order);
+
+    /**
+     * Expands the i-th tree.
+     *
+     * @returns The same tree that was added
+    */
+    Tree tree(int i) const;
+
+    /**
+     * Gets the pre-order traversal of the i-th tree without expanding it.
+    */
+    std::string pre_order(int i) const;
+
+    /**
+     * Gets the number of bytes held by the corpus.
+    */
+    std::size_t bytes() const;
+
+    /**
+     * Releases the memory reserved for trees that were never added.
+    */
+    void shrink_to_fit();
+
+private:
+    // Number of parentheses in the corpus.
+    std::uint64_t bits;
+
+    void push_paren(bool opening);
+    void push_label(int label);
+    void put(std::uint64_t node, std::uint64_t z);
+    std::uint64_t label_bits(std::uint64_t node) const;
+    int label(std::uint64_t node) const;
+};
+
+#endif
@@ -0,0 +1,12 @@
+#include <preparedTree.h>
+#include <algorithm>
+
+PreparedTree::PreparedTree() {
+}
+
+PreparedTree::PreparedTree(const Tree& t) : tree(t) {
+    rightmost = t.rightmost();
+
+    keyroots = t.keyroots_r();
+    std::reverse(keyroots.begin(), keyroots.end());
+}
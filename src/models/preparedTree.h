@@ -0,0 +1,38 @@
+#ifndef PREPAREDTREE_H
+#define PREPAREDTREE_H
+
+#include <tree.h>
+#include <vector>
+
+/**
+ * A tree along with the structural arrays that tree edit distance algorithms derive from it.
+ * 
+ * Deriving these arrays takes linear time, which dominates the cost of comparing small trees. A tree that
+ * takes part in many comparisons can be prepared once and reused.
+*/
+struct PreparedTree {
+    // The tree itself.
+    Tree tree;
+
+    // Maps a node to its rightmost leaf.
+    std::vector<int> rightmost;
+
+    // Keyroots of T for the rightmost leaves in decreasing order.
+    std::vector<int> keyroots;
+
+    /**
+     * Constructs an empty prepared tree.
+    */
+    PreparedTree();
+
+    /**
+     * Derives the structural arrays of T.
+     * 
+     * The running time complexity is of the order O(n) where n corresponds to the number of nodes in T.
+     * 
+     * @param t An ordered labeled rooted tree
+    */
+    PreparedTree(const Tree& t);
+};
+
+#endif
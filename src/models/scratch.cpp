@@ -0,0 +1,68 @@
+#include <scratch.h>
+#include <new>
+#include <vector>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <stdlib.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+Scratch::Scratch(std::size_t bytes, bool spill, const std::string& dir) : memory(nullptr), bytes(bytes), mapped(false) {
+#ifndef _WIN32
+    if (spill && bytes > 0) {
+        std::string name = (dir.empty() ? std::string("/tmp") : dir) + "/ted-scratch-XXXXXX";
+        std::vector<char> path(name.begin(), name.end());
+        path.push_back('\0');
+
+        int fd = mkstemp(path.data());
+
+        if (fd < 0) {
+            throw std::bad_alloc();
+        }
+
+        // The name is not needed once the file is open, and removing it right away means that it cannot outlive
+        // the process
+        unlink(path.data());
+
+        if (ftruncate(fd, bytes) != 0) {
+            close(fd);
+            throw std::bad_alloc();
+        }
+
+        void* m = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+        close(fd);
+
+        if (m == MAP_FAILED) {
+            throw std::bad_alloc();
+        }
+
+        memory = m;
+        mapped = true;
+
+        return;
+    }
+#endif
+
+    memory = ::operator new(bytes > 0 ? bytes : 1);
+}
+
+Scratch::~Scratch() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap(memory, bytes);
+        return;
+    }
+#endif
+
+    ::operator delete(memory);
+}
+
+void* Scratch::data() const {
+    return memory;
+}
+
+bool Scratch::spilled() const {
+    return mapped;
+}
@@ -0,0 +1,50 @@
+#ifndef SCRATCH_H
+#define SCRATCH_H
+
+#include <cstddef>
+#include <string>
+
+/**
+ * A block of memory that is either taken from the heap or backed by a temporary file mapped into memory.
+ *
+ * Pages of a file mapping can be written back and dropped by the operating system whenever memory runs short, so
+ * a computation whose tables do not fit in memory slows down rather than being killed. The file is removed as soon
+ * as it is mapped, and its space is reclaimed when the block is destroyed.
+ *
+ * Memory is not initialized. Mapping a file is only supported on POSIX systems, and elsewhere the heap is used.
+*/
+struct Scratch {
+    /**
+     * Allocates a block of the given size.
+     *
+     * @param bytes The size of the block
+     * @param spill Whether the block should be backed by a file rather than the heap
+     * @param dir The directory where the file is created
+    */
+    Scratch(std::size_t bytes, bool spill, const std::string& dir);
+
+    /**
+     * Releases the block and removes its file.
+    */
+    ~Scratch();
+
+    Scratch(const Scratch&) = delete;
+    Scratch& operator=(const Scratch&) = delete;
+
+    /**
+     * Gets the start of the block.
+    */
+    void* data() const;
+
+    /**
+     * Whether the block ended up backed by a file.
+    */
+    bool spilled() const;
+
+private:
+    void* memory;
+    std::size_t bytes;
+    bool mapped;
+};
+
+#endif
@@ -0,0 +1,39 @@
+#include <subtreeTable.h>
+#include <cstdint>
+
+std::size_t SubtreeTable::Hash::operator()(const std::vector<int>& key) const {
+    std::uint64_t h = 1469598103934665603ULL;
+
+    for (int x: key) {
+        h ^= static_cast<std::uint32_t>(x);
+        h *= 1099511628211ULL;
+        h ^= h >> 29;
+    }
+
+    return static_cast<std::size_t>(h);
+}
+
+std::vector<int> SubtreeTable::canonical(const Tree& t) {
+    std::vector<int> id(t.n + 1);
+    std::vector<int> key;
+
+    // Nodes are processed in reverse pre-order so that every child has an id before its parent
+    for (int u = t.n; u >= 1; --u) {
+        key.clear();
+        key.push_back(t.labels[u]);
+
+        for (int v: t.adj[u]) {
+            key.push_back(id[v]);
+        }
+
+        auto it = ids.find(key);
+
+        if (it == ids.end()) {
+            it = ids.insert({key, static_cast<int>(ids.size())}).first;
+        }
+
+        id[u] = it->second;
+    }
+
+    return id;
+}
@@ -0,0 +1,40 @@
+#ifndef SUBTREETABLE_H
+#define SUBTREETABLE_H
+
+#include <tree.h>
+#include <vector>
+#include <unordered_map>
+#include <cstddef>
+
+/**
+ * Assigns canonical ids to subtrees such that two subtrees get the same id if and only if they have the same
+ * labels and the same shape.
+ * 
+ * The id of a node u is obtained by hash-consing the label of u together with the ids of its children, in the
+ * same way a Merkle tree combines the hashes of its children. Ids are only comparable between trees that were
+ * processed by the same table.
+*/
+struct SubtreeTable {
+    /**
+     * Hashes the label and the children ids of a node.
+    */
+    struct Hash {
+        std::size_t operator()(const std::vector<int>& key) const;
+    };
+
+    // Maps the label of a node followed by the ids of its children to the id of its subtree.
+    std::unordered_map<std::vector<int>, int, Hash> ids;
+
+    /**
+     * Computes the canonical id of every subtree of T.
+     * 
+     * It requires O(n) expected time where n corresponds to the number of nodes in T.
+     * 
+     * @param t An ordered labeled rooted tree
+     * 
+     * @returns A map to get the canonical id of the subtree rooted at any node of T
+    */
+    std::vector<int> canonical(const Tree& t);
+};
+
+#endif
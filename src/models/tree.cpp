@@ -3,6 +3,8 @@
 #include <unordered_set>
 #include <stack>
 #include <algorithm>
+#include <cctype>
+#include <charconv>
 
 Tree::Tree() {
     root = -1;
@@ -62,6 +64,55 @@ Tree::Tree(const std::string& pre_order) {
     labels = std::vector<int>(labels.begin(), labels.begin() + idx);
 }
 
+bool Tree::valid(const std::string& pre_order) {
+    // Number of subtrees that are open
+    int depth = 0;
+    // Whether the root was seen, since a second tree at the top level would make a forest
+    bool root = false;
+    std::size_t i = 0;
+
+    while (i < pre_order.size()) {
+        if (pre_order[i] == ')') {
+            if (depth == 0) {
+                return false;
+            }
+
+            --depth;
+            ++i;
+            continue;
+        }
+
+        if (depth == 0 && root) {
+            return false;
+        }
+
+        root = true;
+
+        // A label followed by the parenthesis that opens its sub-tree
+        std::size_t start = i;
+
+        if (pre_order[i] == '-') {
+            ++i;
+        }
+
+        while (i < pre_order.size() && std::isdigit(static_cast<unsigned char>(pre_order[i]))) {
+            ++i;
+        }
+
+        int label;
+        auto r = std::from_chars(pre_order.data() + start, pre_order.data() + i, label);
+
+        if (r.ec != std::errc() || r.ptr != pre_order.data() + i || i >= pre_order.size() || pre_order[i] != '(') {
+            return false;
+        }
+
+        ++depth;
+        ++i;
+    }
+
+    return depth == 0;
+}
+
 std::string Tree::pre_order() const {
     if (root < 0) {
         return std::string();
@@ -129,27 +180,18 @@ std::string Tree::pre_order(int l, int r, const std::unordered_set<int>& exclude
 }
 
 std::vector<int> Tree::size_subtrees() const {
-    // Let us first do a depth first traversal of the tree where
-    // we compute size(u) for all u. Size(u) is defined as the number
-    // of nodes in the sub-tree rooted at u plus u itself.
+    // Size(u) is defined as the number of nodes in the sub-tree rooted at u plus u itself.
+    // Nodes are numbered in pre-order, so every child is done before its parent when going backwards,
+    // without any recursion that deep trees would overflow.
 
     std::vector<int> size(n + 1);
-    std::unordered_set<int> visited;
 
-    std::function<void(int)> dfs = [&](int u) {
+    for (int u = n; u >= 1; --u) {
         size[u] = 1;
-        visited.insert(u);
-        
+
         for (int v: adj[u]) {
-            dfs(v);
             size[u] += size[v];
         }
-    };
-
-    for (int i = 1; i < n; ++i) {
-        if (visited.count(i) <= 0) {
-            dfs(i);
-        }
     }
 
     return size;
@@ -199,29 +241,15 @@ std::vector<std::vector<int>> Tree::decompose() const {
 }
 
 std::vector<int> Tree::leftmost() const {
-    // We will first compute the leftmost node for each node u
-    std::vector<int> ll(n + 1);
-    std::unordered_set<int> visited;
-
-    std::function<void(int)> dfs = [&](int u) {
-        ll[u] = u;
-        visited.insert(u);
-
-        for (int i = adj[u].size() - 1; i >= 0; --i) {
-            int v = adj[u][i];
-            dfs(v);
-            ll[u] = ll[v];
-        }
-    };
-
     if (root == -1) {
         return std::vector<int>();
     }
 
-    for (int i = 1; i <= n; ++i) {
-        if (visited.count(i) <= 0) {
-            dfs(i);
-        }
+    // Nodes are numbered in pre-order, so every child is done before its parent when going backwards
+    std::vector<int> ll(n + 1);
+
+    for (int u = n; u >= 1; --u) {
+        ll[u] = adj[u].empty() ? u : ll[adj[u].front()];
     }
 
     return ll;
@@ -230,14 +258,15 @@ std::vector<int> Tree::leftmost() const {
 std::vector<int> Tree::keyroots_l() const {
     std::vector<int> ll = leftmost();
 
-    std::unordered_set<int> r;
+    // Whether a node with each leaf was seen. Nodes are visited in pre-order, so the first is closest to the root
+    std::vector<char> seen(n + 1, false);
     std::vector<int> keyroots;
 
     for (int u = 1; u <= n; ++u) {
         int l = ll[u];
 
-        if (r.count(l) <= 0) {
-            r.insert(l);
+        if (!seen[l]) {
+            seen[l] = true;
             keyroots.push_back(u);
         }
     }
@@ -246,28 +275,15 @@ std::vector<int> Tree::keyroots_l() const {
 }
 
 std::vector<int> Tree::rightmost() const {
-    // We will first compute the rightmost node for each node u
-    std::vector<int> rl(n + 1);
-    std::unordered_set<int> visited;
-
-    std::function<void(int)> dfs = [&](int u) {
-        rl[u] = u;
-        visited.insert(u);
-
-        for (int v: adj[u]) {
-            dfs(v);
-            rl[u] = rl[v];
-        }
-    };
-
     if (root == -1) {
         return std::vector<int>();
     }
 
-    for (int i = 1; i <= n; ++i) {
-        if (visited.count(i) <= 0) {
-            dfs(i);
-        }
+    // Nodes are numbered in pre-order, so every child is done before its parent when going backwards
+    std::vector<int> rl(n + 1);
+
+    for (int u = n; u >= 1; --u) {
+        rl[u] = adj[u].empty() ? u : rl[adj[u].back()];
     }
 
     return rl;
@@ -276,14 +292,15 @@ std::vector<int> Tree::rightmost() const {
 std::vector<int> Tree::keyroots_r() const {
     std::vector<int> rl = rightmost();
 
-    std::unordered_set<int> r;
+    // Whether a node with each leaf was seen. Nodes are visited in pre-order, so the first is closest to the root
+    std::vector<char> seen(n + 1, false);
     std::vector<int> keyroots;
 
     for (int u = 1; u <= n; ++u) {
         int l = rl[u];
 
-        if (r.count(l) <= 0) {
-            r.insert(l);
+        if (!seen[l]) {
+            seen[l] = true;
             keyroots.push_back(u);
         }
     }
@@ -311,6 +328,46 @@ std::vector<int> Tree::depth() const {
     return d;
 }
 
+Tree Tree::mirror() const {
+    Tree m;
+
+    if (root < 0) {
+        return m;
+    }
+
+    m.n = n;
+    m.root = 1;
+    m.adj = std::vector<std::vector<int>>(n + 1);
+    m.parent = std::vector<int>(n + 1);
+    m.labels = std::vector<int>(n + 1);
+
+    // Pairs of a node of T and the id of its parent in the mirror image. Children are pushed in their order in T,
+    // so the last one is popped first.
+    std::stack<std::pair<int, int>> s;
+    for (int r: adj[0]) {
+        s.push({r, 0});
+    }
+
+    int idx = 1;
+
+    while (!s.empty()) {
+        auto [u, p] = s.top();
+        s.pop();
+
+        m.adj[p].push_back(idx);
+        m.parent[idx] = p;
+        m.labels[idx] = labels[u];
+
+        for (int v: adj[u]) {
+            s.push({v, idx});
+        }
+
+        ++idx;
+    }
+
+    return m;
+}
+
 std::vector<int> Tree::get_upwards_path(int u, int v) const {
     std::vector<int> p;
 
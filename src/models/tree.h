@@ -53,6 +53,17 @@ struct Tree {
     */
     Tree(const std::string& pre_order);
 
+    /**
+     * Checks whether a string is a pre-order traversal that can be given to the constructor, where every label is
+     * an integer followed by the parenthesis that encloses its sub-tree, parenthesis are balanced and there is a
+     * single root. The empty string is the empty tree.
+     * 
+     * @param pre_order The string to check
+     * 
+     * @returns Whether the string represents a tree
+    */
+    static bool valid(const std::string& pre_order);
+
     /**
      * Gets a preorder string unique representation of T in linear time.
      * For instance, the tree
@@ -167,6 +178,15 @@ struct Tree {
     */
     std::vector<int> depth() const;
 
+    /**
+     * Gets the mirror image of T, where the children of every node are in reverse order. Nodes are numbered again
+     * in pre-order.
+     * 
+     * The tree edit distance between the mirror images of two trees is the same as between the trees, and the
+     * leftmost paths of T are the rightmost paths of its mirror image.
+    */
+    Tree mirror() const;
+
     /**
      * Gets the path upwards from node u to node v.
      *
@@ -0,0 +1,53 @@
+#include <workspace.h>
+#include <algorithm>
+
+// Size of the first chunk. Later chunks double in size.
+static const std::size_t MIN_CHUNK_SIZE = 1 << 16;
+
+Workspace::Workspace() {
+    chunk = 0;
+    offset = 0;
+}
+
+Workspace::Mark Workspace::mark() const {
+    return Mark{chunk, offset};
+}
+
+void Workspace::release(const Mark& m) {
+    chunk = m.chunk;
+    offset = m.offset;
+}
+
+void Workspace::reset() {
+    chunk = 0;
+    offset = 0;
+}
+
+Workspace& Workspace::local() {
+    thread_local Workspace ws;
+    return ws;
+}
+
+void* Workspace::allocate(std::size_t bytes, std::size_t align) {
+    while (chunk < chunks.size()) {
+        std::size_t start = (offset + align - 1) / align * align;
+
+        if (start + bytes <= chunks[chunk].second) {
+            offset = start + bytes;
+            return chunks[chunk].first.get() + start;
+        }
+
+        // The request does not fit in the current chunk, so move on to the next one
+        ++chunk;
+        offset = 0;
+    }
+
+    // Every chunk is in use, so we need a new one that is large enough for this request
+    std::size_t size = std::max(bytes + align, chunks.empty() ? MIN_CHUNK_SIZE : 2 * chunks.back().second);
+    chunks.push_back({std::unique_ptr<char[]>(new char[size]), size});
+
+    chunk = chunks.size() - 1;
+    offset = 0;
+
+    return allocate(bytes, align);
+}
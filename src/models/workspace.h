@@ -0,0 +1,129 @@
+#ifndef WORKSPACE_H
+#define WORKSPACE_H
+
+#include <vector>
+#include <memory>
+#include <cstddef>
+
+/**
+ * A scratch arena used by the dynamic programming routines to obtain their tables.
+ *
+ * Memory is carved out of large chunks that stay alive between calls, so once the arena is warm, handing out
+ * a table does not reach the system allocator. Memory is handed out in stack order. A mark taken at any
+ * point can be used to discard everything allocated after it in O(1) time.
+ *
+ * A workspace must not be shared between threads. Use Workspace::local() to get one per thread.
+*/
+struct Workspace {
+    /**
+     * A view over a one dimensional array whose valid indices are [lo, hi].
+    */
+    template <typename T>
+    struct Array {
+        T* data;
+        int lo;
+        int hi;
+
+        T& operator[](int i) const {
+            return data[i - lo];
+        }
+
+        operator Array<const T>() const {
+            return Array<const T>{data, lo, hi};
+        }
+    };
+
+    /**
+     * A view over a two dimensional table whose valid indices are [il, ir] x [jl, jr].
+     *
+     * Entries are stored contiguously row by row.
+    */
+    template <typename T>
+    struct Table {
+        // A single row of the table
+        struct Row {
+            T* data;
+            int jl;
+
+            T& operator[](int j) const {
+                return data[j - jl];
+            }
+        };
+
+        T* data;
+        int il;
+        int ir;
+        int jl;
+        int jr;
+
+        Row operator[](int i) const {
+            return Row{data + static_cast<std::size_t>(i - il) * (jr - jl + 1), jl};
+        }
+    };
+
+    /**
+     * A position in the arena. Releasing a mark discards every allocation made after it was taken.
+    */
+    struct Mark {
+        std::size_t chunk;
+        std::size_t offset;
+    };
+
+    /**
+     * Constructs an empty workspace. No memory is reserved until the first allocation.
+    */
+    Workspace();
+
+    /**
+     * Allocates an uninitialized array with valid indices [lo, hi].
+    */
+    template <typename T>
+    Array<T> array(int lo, int hi) {
+        T* data = static_cast<T*>(allocate(sizeof(T) * static_cast<std::size_t>(hi - lo + 1), alignof(T)));
+        return Array<T>{data, lo, hi};
+    }
+
+    /**
+     * Allocates an uninitialized table with valid indices [il, ir] x [jl, jr].
+    */
+    template <typename T>
+    Table<T> table(int il, int ir, int jl, int jr) {
+        std::size_t cells = static_cast<std::size_t>(ir - il + 1) * static_cast<std::size_t>(jr - jl + 1);
+        T* data = static_cast<T*>(allocate(sizeof(T) * cells, alignof(T)));
+        return Table<T>{data, il, ir, jl, jr};
+    }
+
+    /**
+     * Gets the current position of the arena.
+    */
+    Mark mark() const;
+
+    /**
+     * Discards every allocation made after the given mark was taken.
+    */
+    void release(const Mark& m);
+
+    /**
+     * Discards every allocation. Chunks are kept for later use.
+    */
+    void reset();
+
+    /**
+     * Gets the workspace owned by the calling thread.
+    */
+    static Workspace& local();
+
+private:
+    // Chunks of raw memory along with their capacity in bytes
+    std::vector<std::pair<std::unique_ptr<char[]>, std::size_t>> chunks;
+
+    // Index of the chunk allocations are currently taken from
+    std::size_t chunk;
+
+    // Number of bytes already handed out from the current chunk
+    std::size_t offset;
+
+    void* allocate(std::size_t bytes, std::size_t align);
+};
+
+#endif
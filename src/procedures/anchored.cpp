@@ -0,0 +1,217 @@
+#include <anchored.h>
+#include <subtreeTable.h>
+#include <workspace.h>
+#include <algorithm>
+
+namespace {
+    /**
+     * A tree where some leaves stand for a whole subtree of the original tree.
+    */
+    struct Collapsed {
+        Tree tree;
+        // Cost of deleting or inserting each node, which is the size of the subtree a collapsed leaf stands for.
+        std::vector<int> weight;
+        // Anchor a collapsed leaf stands for, or 0 for any other node.
+        std::vector<int> anchor;
+    };
+
+    /**
+     * Replaces the subtree rooted at every anchored node of T by a single leaf. Nodes keep their pre-order.
+     *
+     * @param anchors The anchor of every node of T whose subtree is collapsed, or 0 for any other node
+    */
+    Collapsed collapse(const Tree& t, const std::vector<int>& size, const std::vector<int>& anchors) {
+        Collapsed c;
+        c.tree.adj.push_back({});
+        c.tree.parent.push_back(0);
+        c.tree.labels.push_back(0);
+        c.weight.push_back(0);
+        c.anchor.push_back(0);
+
+        std::vector<int> index(t.n + 1, 0);
+
+        for (int u = 1; u <= t.n; ) {
+            int x = c.tree.adj.size();
+            int p = index[t.parent[u]];
+
+            index[u] = x;
+
+            c.tree.adj.push_back({});
+            c.tree.adj[p].push_back(x);
+            c.tree.parent.push_back(p);
+            c.tree.labels.push_back(t.labels[u]);
+            c.anchor.push_back(anchors[u]);
+
+            if (anchors[u] != 0) {
+                c.weight.push_back(size[u]);
+                u += size[u];
+            } else {
+                c.weight.push_back(1);
+                ++u;
+            }
+        }
+
+        c.tree.n = c.tree.adj.size() - 1;
+        c.tree.root = 1;
+
+        return c;
+    }
+
+    /**
+     * Computes the TED between two collapsed trees with ZhangShasha, where deleting or inserting a node costs its
+     * weight and a collapsed leaf can only be mapped to its partner for free.
+    */
+    int weighted_ted(const Collapsed& a, const Collapsed& b) {
+        const Tree& t1 = a.tree;
+        const Tree& t2 = b.tree;
+
+        std::vector<int> t1_rightmost = t1.rightmost();
+        std::vector<int> t2_rightmost = t2.rightmost();
+
+        auto cost = [&](int i, int j) {
+            if (a.anchor[i] != 0 || b.anchor[j] != 0) {
+                return a.anchor[i] == b.anchor[j] ? 0 : a.weight[i] + b.weight[j];
+            }
+
+            return t1.labels[i] == t2.labels[j] ? 0 : 1;
+        };
+
+        Workspace& ws = Workspace::local();
+        Workspace::Mark start = ws.mark();
+
+        Workspace::Table<int> td = ws.table<int>(1, t1.n, 1, t2.n);
+
+        // Keyroots are processed in decreasing order so that the pairs below them are done first
+        std::vector<int> t1_keyroots = t1.keyroots_r();
+        std::reverse(t1_keyroots.begin(), t1_keyroots.end());
+        std::vector<int> t2_keyroots = t2.keyroots_r();
+        std::reverse(t2_keyroots.begin(), t2_keyroots.end());
+
+        for (int k: t1_keyroots) {
+            int rk = t1_rightmost[k];
+
+            for (int l: t2_keyroots) {
+                int rl = t2_rightmost[l];
+
+                Workspace::Mark mark = ws.mark();
+                Workspace::Table<int> fd = ws.table<int>(k, rk + 1, l, rl + 1);
+
+                fd[rk + 1][rl + 1] = 0;
+                for (int i = rk; i >= k; --i) {
+                    fd[i][rl + 1] = fd[i + 1][rl + 1] + a.weight[i];
+                }
+                for (int j = rl; j >= l; --j) {
+                    fd[rk + 1][j] = fd[rk + 1][j + 1] + b.weight[j];
+                }
+
+                for (int i = rk; i >= k; --i) {
+                    for (int j = rl; j >= l; --j) {
+                        int d = std::min(fd[i + 1][j] + a.weight[i], fd[i][j + 1] + b.weight[j]);
+
+                        if (t1_rightmost[i] == rk && t2_rightmost[j] == rl) {
+                            fd[i][j] = std::min(d, fd[i + 1][j + 1] + cost(i, j));
+                            td[i][j] = fd[i][j];
+                        } else {
+                            fd[i][j] = std::min(d, fd[t1_rightmost[i] + 1][t2_rightmost[j] + 1] + td[i][j]);
+                        }
+                    }
+                }
+
+                ws.release(mark);
+            }
+        }
+
+        int d = td[1][1];
+
+        ws.release(start);
+
+        return d;
+    }
+}
+
+int Anchored::ted(const Tree& t1, const Tree& t2, Stats& stats) {
+    stats = Stats();
+
+    if (t1.n == 0 || t2.n == 0) {
+        return t1.n + t2.n;
+    }
+
+    SubtreeTable table;
+    std::vector<int> ids1 = table.canonical(t1);
+    std::vector<int> ids2 = table.canonical(t2);
+
+    std::vector<int> size1 = t1.size_subtrees();
+    std::vector<int> size2 = t2.size_subtrees();
+
+    // Number of occurrences of every subtree in each tree, and where it occurs in T2
+    std::vector<int> count1(table.ids.size(), 0);
+    std::vector<int> count2(table.ids.size(), 0);
+    std::vector<int> where2(table.ids.size(), 0);
+
+    for (int u = 1; u <= t1.n; ++u) {
+        ++count1[ids1[u]];
+    }
+
+    for (int v = 1; v <= t2.n; ++v) {
+        ++count2[ids2[v]];
+        where2[ids2[v]] = v;
+    }
+
+    // Subtrees that occur once in each tree, found top-down so that the subtrees of a match are not considered.
+    // They come out in pre-order of T1.
+    std::vector<std::pair<int, int>> matches;
+
+    for (int u = 1; u <= t1.n; ) {
+        int x = ids1[u];
+
+        if (count1[x] == 1 && count2[x] == 1) {
+            matches.push_back({u, where2[x]});
+            u += size1[u];
+        } else {
+            ++u;
+        }
+    }
+
+    // Matches are disjoint subtrees, so a set of them is a valid mapping if their order is the same in both
+    // trees. Keep the one that covers the most nodes with a weighted longest increasing subsequence over the
+    // positions in T2, using a Fenwick tree of the best weight ending before each position.
+    std::vector<std::pair<long long, int>> fenwick(t2.n + 1, {0, -1});
+    std::vector<int> previous(matches.size(), -1);
+    std::vector<long long> best(matches.size(), 0);
+
+    for (int a = 0; a < matches.size(); ++a) {
+        std::pair<long long, int> before = {0, -1};
+
+        for (int v = matches[a].second - 1; v > 0; v -= v & -v) {
+            before = std::max(before, fenwick[v]);
+        }
+
+        best[a] = before.first + size1[matches[a].first];
+        previous[a] = before.second;
+
+        for (int v = matches[a].second; v <= t2.n; v += v & -v) {
+            fenwick[v] = std::max(fenwick[v], std::make_pair(best[a], a));
+        }
+    }
+
+    std::vector<int> anchors1(t1.n + 1, 0);
+    std::vector<int> anchors2(t2.n + 1, 0);
+
+    int last = std::max_element(best.begin(), best.end()) - best.begin();
+
+    for (int a = matches.empty() ? -1 : last; a != -1; a = previous[a]) {
+        anchors1[matches[a].first] = a + 1;
+        anchors2[matches[a].second] = a + 1;
+
+        ++stats.anchors;
+        stats.matched += size1[matches[a].first];
+    }
+
+    Collapsed c1 = collapse(t1, size1, anchors1);
+    Collapsed c2 = collapse(t2, size2, anchors2);
+
+    stats.residual1 = c1.tree.n;
+    stats.residual2 = c2.tree.n;
+
+    return weighted_ted(c1, c2);
+}
@@ -0,0 +1,48 @@
+#ifndef ANCHORED_H
+#define ANCHORED_H
+
+#include <tree.h>
+
+/**
+ * Approximates the Tree Edit Distance (TED) between two large and mostly similar trees by anchoring the parts
+ * they have in common, in the same way diff tools do.
+ *
+ * Subtrees that occur exactly once in each tree with the same labels and shape are matched top-down, so only
+ * maximal ones are kept. Matched subtrees are disjoint, and the largest set of them whose order agrees in both
+ * trees is chosen. Every chosen subtree is then collapsed into a single leaf, and an exact engine runs on what
+ * remains. A collapsed leaf costs as much as the subtree it stands for, and can only be mapped to its partner.
+ *
+ * Every mapping between the collapsed trees extends to a mapping between the original ones with the same cost,
+ * so the result is an upper bound for TED. It is exact whenever the optimal mapping keeps the anchors.
+*/
+namespace Anchored {
+    /**
+     * Counters that describe the anchoring of a pair of trees.
+    */
+    struct Stats {
+        // Number of subtrees matched in both trees.
+        int anchors = 0;
+        // Number of nodes of T1 inside the matched subtrees.
+        int matched = 0;
+        // Number of nodes of the collapsed T1 and T2 that the exact engine ran on.
+        int residual1 = 0;
+        int residual2 = 0;
+    };
+
+    /**
+     * Computes an upper bound for the TED between T1 and T2 by running an exact engine on the parts of T1 and T2
+     * that are not identical subtrees of each other.
+     *
+     * It requires O(n + m) expected time for the anchoring, plus the time of ZhangShasha on the collapsed trees.
+     *
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param stats Counters that will be filled in with the work done
+     *
+     * @returns A number of operations that is enough to transform t1 into t2, which is never smaller than the
+     * tree edit distance.
+    */
+    int ted(const Tree& t1, const Tree& t2, Stats& stats);
+}
+
+#endif
@@ -0,0 +1,53 @@
+#include <anytime.h>
+#include <bounds.h>
+#include <constrained.h>
+#include <shapes.h>
+#include <zhangShasha.h>
+#include <algorithm>
+
+Anytime::Result Anytime::ted(const Tree& t1, const Tree& t2, const CancelToken& token, const Engine& engine) {
+    Result r;
+
+    if (t1.n == 0 || t2.n == 0) {
+        r.lower = r.upper = t1.n + t2.n;
+        r.exact = true;
+        return r;
+    }
+
+    r.lower = Bounds::lower_bound(Bounds::signature(t1), Bounds::signature(t2));
+
+    // Mapping the roots to each other and nothing else is always possible
+    r.upper = t1.n + t2.n - 2 + (t1.labels[1] == t2.labels[1] ? 0 : 1);
+
+    if (r.lower < r.upper) {
+        int c = Constrained::ted(t1, t2, token);
+
+        if (c >= 0) {
+            r.upper = std::min(r.upper, c);
+        }
+    }
+
+    if (r.lower < r.upper) {
+        int d = engine(t1, t2, token);
+
+        if (d >= 0) {
+            r.lower = r.upper = d;
+        }
+    }
+
+    r.exact = r.lower == r.upper;
+
+    return r;
+}
+
+Anytime::Result Anytime::ted(const Tree& t1, const Tree& t2, const CancelToken& token) {
+    return Anytime::ted(t1, t2, token, [](const Tree& a, const Tree& b, const CancelToken& t) {
+        int d = -1;
+
+        if (Shapes::ted(a, b, d)) {
+            return d;
+        }
+
+        return ZhangShasha::ted(a, b, t);
+    });
+}
@@ -0,0 +1,55 @@
+#ifndef ANYTIME_H
+#define ANYTIME_H
+
+#include <tree.h>
+#include <cancelToken.h>
+#include <functional>
+
+/**
+ * Computes the Tree Edit Distance (TED) within a deadline, and falls back to the best bounds found so far when the
+ * exact engine does not finish in time.
+ *
+ * Bounds are computed from the cheapest to the most expensive. The label histogram lower bound and a trivial upper
+ * bound come first, then the constrained edit distance, which is a tighter upper bound, and finally the exact
+ * distance. Every step but the first one gives up as soon as the token expires.
+*/
+namespace Anytime {
+    /**
+     * The distance between two trees, or the range it lies in.
+    */
+    struct Result {
+        // A number of operations that is never greater than the tree edit distance.
+        int lower = 0;
+        // A number of operations that is enough to transform T1 into T2.
+        int upper = 0;
+        // Whether both bounds are the tree edit distance.
+        bool exact = false;
+    };
+
+    /**
+     * An exact algorithm that returns -1 when the token expires before it is done.
+    */
+    typedef std::function<int(const Tree&, const Tree&, const CancelToken&)> Engine;
+
+    /**
+     * Computes the TED between T1 and T2, or bounds for it if the token expires first.
+     *
+     * If the bounds meet before the exact engine runs, the result is exact without running it.
+     *
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param token The token that tells when to stop
+     * @param engine The exact algorithm to run last
+     *
+     * @returns The tree edit distance, or the best bounds found before the token expired
+    */
+    Result ted(const Tree& t1, const Tree& t2, const CancelToken& token, const Engine& engine);
+
+    /**
+     * Computes the TED between T1 and T2 like ted does, with ZhangShasha as the exact engine. Paths and stars are
+     * solved as string edit distance first.
+    */
+    Result ted(const Tree& t1, const Tree& t2, const CancelToken& token);
+}
+
+#endif
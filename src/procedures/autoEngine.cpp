@@ -0,0 +1,130 @@
+#include <autoEngine.h>
+#include <zhangShasha.h>
+#include <shapes.h>
+
+namespace {
+    /**
+     * Work done by the keyroots of one tree.
+    */
+    struct Count {
+        // Number of keyroots.
+        long long keyroots = 0;
+        // Sum over every keyroot of the size of its subtree plus one, that is the side of its forest tables.
+        long long sides = 0;
+    };
+
+    /**
+     * Counts the keyroots of T when it is decomposed along its rightmost paths, or along its leftmost paths if
+     * left is set. A node is a keyroot if it is a root, or if it is not the last child, or the first child, of its
+     * parent.
+    */
+    Count count(const Tree& t, bool left) {
+        Count c;
+
+        // Nodes are numbered in pre-order, so every child comes after its parent
+        std::vector<int> size(t.n + 1, 1);
+        for (int u = t.n; u >= 1; --u) {
+            if (t.parent[u] > 0) {
+                size[t.parent[u]] += size[u];
+            }
+        }
+
+        for (int u = 1; u <= t.n; ++u) {
+            const std::vector<int>& siblings = t.adj[t.parent[u]];
+            int edge = left ? siblings.front() : siblings.back();
+
+            if (t.parent[u] == 0 || edge != u) {
+                ++c.keyroots;
+                c.sides += size[u] + 1;
+            }
+        }
+
+        return c;
+    }
+
+    /**
+     * Runs the given ZhangShasha variant on the trees arranged as the plan says.
+    */
+    template <typename Engine>
+    int run(const Tree& t1, const Tree& t2, const AutoEngine::Plan& plan, const Engine& engine) {
+        if (plan.shapes) {
+            int d = t1.n + t2.n;
+            Shapes::ted(t1, t2, d);
+
+            return d;
+        }
+
+        if (plan.left) {
+            Tree m1 = t1.mirror();
+            Tree m2 = t2.mirror();
+
+            return plan.swapped ? engine(m2, m1) : engine(m1, m2);
+        }
+
+        return plan.swapped ? engine(t2, t1) : engine(t1, t2);
+    }
+}
+
+std::string AutoEngine::name(const Plan& plan) {
+    if (plan.shapes) {
+        return "Shapes";
+    }
+
+    return std::string("ZhangShasha ") + (plan.left ? "left" : "right") + (plan.swapped ? " swapped" : "");
+}
+
+std::vector<AutoEngine::Plan> AutoEngine::plans(const Tree& t1, const Tree& t2) {
+    std::vector<Plan> result;
+
+    for (bool left: {false, true}) {
+        Count c1 = count(t1, left);
+        Count c2 = count(t2, left);
+
+        for (bool swapped: {false, true}) {
+            Plan plan;
+            plan.left = left;
+            plan.swapped = swapped;
+            plan.cells = c1.sides * c2.sides;
+
+            // Every keyroot pair fills a row for each node of the keyroot of the first tree
+            plan.rows = swapped ? c2.sides * c1.keyroots : c1.sides * c2.keyroots;
+            plan.cost = plan.cells + ROW_COST * plan.rows;
+
+            result.push_back(plan);
+        }
+    }
+
+    return result;
+}
+
+AutoEngine::Plan AutoEngine::choose(const Tree& t1, const Tree& t2) {
+    Plan best;
+
+    if (t1.n == 0 || t2.n == 0 || Shapes::is_path(t1) || Shapes::is_path(t2) || (Shapes::is_star(t1) && Shapes::is_star(t2))) {
+        best.shapes = true;
+        return best;
+    }
+
+    std::vector<Plan> candidates = plans(t1, t2);
+    best = candidates[0];
+
+    for (const Plan& plan: candidates) {
+        if (plan.cost < best.cost) {
+            best = plan;
+        }
+    }
+
+    return best;
+}
+
+int AutoEngine::ted(const Tree& t1, const Tree& t2, const Plan& plan) {
+    return run(t1, t2, plan, [](const Tree& a, const Tree& b) {
+        return ZhangShasha::ted(a, b);
+    });
+}
+
+int AutoEngine::ted(const Tree& t1, const Tree& t2, const Plan& plan, const CancelToken& token) {
+    return run(t1, t2, plan, [&](const Tree& a, const Tree& b) {
+        return ZhangShasha::ted(a, b, token);
+    });
+}
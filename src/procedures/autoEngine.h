@@ -0,0 +1,76 @@
+#ifndef AUTOENGINE_H
+#define AUTOENGINE_H
+
+#include <tree.h>
+#include <cancelToken.h>
+#include <string>
+#include <vector>
+
+/**
+ * Chooses how to compute the Tree Edit Distance (TED) between two trees from a cheap count of the work each choice
+ * takes.
+ *
+ * ZhangShasha fills a table of forest distances for every pair of keyroots, sized by the subtrees of both keyroots.
+ * Its kernel decomposes trees along their rightmost paths, which is slow for trees that lean to the right, as
+ * almost every node is then a keyroot. Running it on the mirror images of both trees decomposes them along their
+ * leftmost paths instead, and gives the same distance. Swapping T1 and T2 fills the same number of cells, but
+ * changes the number of rows, and every row has a fixed cost on top of its cells.
+ *
+ * Saeed and SaeedOpt are never chosen, since every pair of spines they compute already does the work of a pair of
+ * keyroots.
+*/
+namespace AutoEngine {
+    // Cost of starting a row of forest distances, in cells.
+    const long long ROW_COST = 8;
+
+    /**
+     * A way to compute the TED along with the work it takes.
+    */
+    struct Plan {
+        // Whether the trees are solved as strings by Shapes, which makes the rest irrelevant.
+        bool shapes = false;
+        // Whether the trees are decomposed along their leftmost paths by running on their mirror images.
+        bool left = false;
+        // Whether T1 and T2 are swapped.
+        bool swapped = false;
+        // Number of forest distance cells filled.
+        long long cells = 0;
+        // Number of rows of forest distances filled.
+        long long rows = 0;
+        // Estimated cost, that is cells + ROW_COST * rows.
+        long long cost = 0;
+    };
+
+    /**
+     * Gets a readable name for a plan, such as "ZhangShasha left swapped".
+    */
+    std::string name(const Plan& plan);
+
+    /**
+     * Counts the work of every decomposition and orientation of ZhangShasha for T1 and T2.
+     *
+     * It requires O(n + m) time where n and m are the number of nodes in T1 and T2.
+     *
+     * @returns The plans for the rightmost and leftmost decompositions, each without and with swapping the trees
+    */
+    std::vector<Plan> plans(const Tree& t1, const Tree& t2);
+
+    /**
+     * Chooses the cheapest way to compute the TED between T1 and T2.
+    */
+    Plan choose(const Tree& t1, const Tree& t2);
+
+    /**
+     * Computes the TED between T1 and T2 as the given plan says.
+    */
+    int ted(const Tree& t1, const Tree& t2, const Plan& plan);
+
+    /**
+     * Computes the TED between T1 and T2 as the given plan says, but gives up as soon as the token expires.
+     *
+     * @returns The tree edit distance between t1 and t2, or -1 if the token expired first
+    */
+    int ted(const Tree& t1, const Tree& t2, const Plan& plan, const CancelToken& token);
+}
+
+#endif
@@ -0,0 +1,238 @@
+#include <batch.h>
+#include <zhangShasha.h>
+#include <shapes.h>
+#include <parallel.h>
+#include <workspace.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+
+namespace {
+    /**
+     * One cell of the dynamic programming tables for every pair of a batch.
+    */
+    struct alignas(16) Cell {
+        std::uint8_t v[Batch::LANES];
+    };
+
+    /**
+     * Sets every lane of out to min(insert + 1, remove + 1, relabel + cost).
+     *
+     * The result is built in a local cell and stored at the end, so the loop reads and writes whole registers
+     * even though a store through a byte could alias any of the inputs.
+    */
+    inline void step(Cell& out, const Cell& insert, const Cell& remove, const Cell& relabel, const Cell& cost) {
+        Cell r;
+
+        for (int x = 0; x < Batch::LANES; ++x) {
+            std::uint8_t a = std::min(insert.v[x], remove.v[x]) + 1;
+            std::uint8_t b = relabel.v[x] + cost.v[x];
+
+            r.v[x] = std::min(a, b);
+        }
+
+        out = r;
+    }
+
+    /**
+     * Sets every lane of out to the lanes of from plus one.
+    */
+    inline void increment(Cell& out, const Cell& from) {
+        Cell r;
+
+        for (int x = 0; x < Batch::LANES; ++x) {
+            r.v[x] = from.v[x] + 1;
+        }
+
+        out = r;
+    }
+
+    /**
+     * Gets a key that is the same for two pairs if and only if their trees have the same shapes.
+    */
+    std::string shapes(const Tree& t1, const Tree& t2) {
+        std::string key(1, static_cast<char>(t1.n));
+
+        // Nodes are numbered in pre-order, so the parent of every node tells the whole shape
+        for (int u = 1; u <= t1.n; ++u) {
+            key += static_cast<char>(t1.parent[u]);
+        }
+        for (int u = 1; u <= t2.n; ++u) {
+            key += static_cast<char>(t2.parent[u]);
+        }
+
+        return key;
+    }
+
+    /**
+     * Computes the TED of a single pair, with the same fast paths as ted.exe.
+    */
+    int scalar(const Tree& t1, const Tree& t2) {
+        int d = -1;
+
+        if (Shapes::ted(t1, t2, d)) {
+            return d;
+        }
+
+        return ZhangShasha::ted(t1, t2);
+    }
+}
+
+void Batch::ted_lanes(const Tree* const* t1, const Tree* const* t2, int* d, int count) {
+    const Tree& s1 = *t1[0];
+    const Tree& s2 = *t2[0];
+
+    int n = s1.n;
+    int m = s2.n;
+
+    if (n == 0 || m == 0) {
+        for (int x = 0; x < count; ++x) {
+            d[x] = n + m;
+        }
+        return;
+    }
+
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    std::vector<int> rl1 = s1.rightmost();
+    std::vector<int> rl2 = s2.rightmost();
+
+    // Keyroots are processed in decreasing order so that the pairs below them are done first
+    std::vector<int> kr1 = s1.keyroots_r();
+    std::reverse(kr1.begin(), kr1.end());
+    std::vector<int> kr2 = s2.keyroots_r();
+    std::reverse(kr2.begin(), kr2.end());
+
+    // Cost of relabeling node i of T1 to node j of T2 in every lane. Unused lanes compare nothing.
+    Workspace::Table<Cell> cost = ws.table<Cell>(1, n, 1, m);
+    for (int i = 1; i <= n; ++i) {
+        for (int j = 1; j <= m; ++j) {
+            Cell& c = cost[i][j];
+
+            for (int x = 0; x < LANES; ++x) {
+                c.v[x] = x < count && t1[x]->labels[i] != t2[x]->labels[j] ? 1 : 0;
+            }
+        }
+    }
+
+    Workspace::Table<Cell> td = ws.table<Cell>(1, n, 1, m);
+    Workspace::Table<Cell> fd = ws.table<Cell>(1, n + 1, 1, m + 1);
+
+    Cell zero = {};
+
+    for (int k: kr1) {
+        int rk = rl1[k];
+
+        for (int l: kr2) {
+            int rl = rl2[l];
+
+            fd[rk + 1][rl + 1] = zero;
+            for (int i = rk; i >= k; --i) {
+                // deletions
+                increment(fd[i][rl + 1], fd[i + 1][rl + 1]);
+            }
+            for (int j = rl; j >= l; --j) {
+                // insertions
+                increment(fd[rk + 1][j], fd[rk + 1][j + 1]);
+            }
+
+            for (int i = rk; i >= k; --i) {
+                auto row = fd[i];
+                auto below = fd[i + 1];
+                auto jump = fd[rl1[i] + 1];
+                auto trees = td[i];
+                auto costs = cost[i];
+
+                bool tree = rl1[i] == rk;
+
+                for (int j = rl; j >= l; --j) {
+                    if (tree && rl2[j] == rl) {
+                        step(row[j], below[j], row[j + 1], below[j + 1], costs[j]);
+                        trees[j] = row[j];
+                    } else {
+                        step(row[j], below[j], row[j + 1], jump[rl2[j] + 1], trees[j]);
+                    }
+                }
+            }
+        }
+    }
+
+    for (int x = 0; x < count; ++x) {
+        d[x] = td[1][1].v[x];
+    }
+
+    ws.release(mark);
+}
+
+std::vector<int> Batch::ted(const std::vector<std::pair<Tree, Tree>>& pairs, Stats& stats, int threads) {
+    std::vector<int> d(pairs.size());
+
+    // Positions of the pairs that share the shapes of both trees
+    std::unordered_map<std::string, std::vector<int>> groups;
+    std::vector<int> single;
+
+    for (int p = 0; p < pairs.size(); ++p) {
+        const Tree& t1 = pairs[p].first;
+        const Tree& t2 = pairs[p].second;
+
+        if (t1.n > 0 && t2.n > 0 && t1.n <= MAX_NODES && t2.n <= MAX_NODES) {
+            groups[shapes(t1, t2)].push_back(p);
+        } else {
+            single.push_back(p);
+        }
+    }
+
+    // Every batch is a range of positions of the same group
+    std::vector<std::vector<int>> batches;
+
+    for (const auto& [key, group]: groups) {
+        for (int lo = 0; lo < group.size(); lo += LANES) {
+            int hi = std::min<int>(group.size(), lo + LANES);
+
+            if (hi - lo >= MIN_LANES) {
+                batches.push_back(std::vector<int>(group.begin() + lo, group.begin() + hi));
+            } else {
+                single.insert(single.end(), group.begin() + lo, group.begin() + hi);
+            }
+        }
+    }
+
+    std::atomic<long long> batched(0);
+
+    Parallel::for_each(batches.size() + single.size(), [&](int b) {
+        if (b >= batches.size()) {
+            int p = single[b - batches.size()];
+            d[p] = scalar(pairs[p].first, pairs[p].second);
+            return;
+        }
+
+        const std::vector<int>& batch = batches[b];
+
+        const Tree* t1[LANES];
+        const Tree* t2[LANES];
+        int out[LANES];
+
+        for (int x = 0; x < batch.size(); ++x) {
+            t1[x] = &pairs[batch[x]].first;
+            t2[x] = &pairs[batch[x]].second;
+        }
+
+        ted_lanes(t1, t2, out, batch.size());
+
+        for (int x = 0; x < batch.size(); ++x) {
+            d[batch[x]] = out[x];
+        }
+
+        batched += batch.size();
+    }, threads);
+
+    stats.pairs += pairs.size();
+    stats.batched += batched;
+    stats.batches += batches.size();
+    stats.scalar += single.size();
+
+    return d;
+}
@@ -0,0 +1,70 @@
+#ifndef BATCH_H
+#define BATCH_H
+
+#include <tree.h>
+#include <vector>
+#include <utility>
+
+/**
+ * Computes the Tree Edit Distance (TED) of many pairs of small trees at once.
+ *
+ * The recurrence of ZhangShasha only looks at the labels when it compares two nodes. Which cells are read and
+ * written, and in what order, only depends on the shapes of both trees. Pairs whose trees have the same shapes are
+ * grouped, and up to LANES of them are computed together with one pair per lane, so that every step of the
+ * recurrence is a single vector instruction over all of them. Distances are at most 2 * MAX_NODES, so cells are
+ * 8 bits wide and a batch fills a 128 bit register.
+ *
+ * Pairs with a larger tree, and groups with too few pairs to fill enough lanes, are computed one at a time.
+*/
+namespace Batch {
+    // Number of pairs computed together.
+    const int LANES = 16;
+
+    // Largest number of nodes of a tree that can be batched.
+    const int MAX_NODES = 32;
+
+    // Smallest number of pairs worth running in lanes. Smaller groups are computed one pair at a time.
+    const int MIN_LANES = 4;
+
+    /**
+     * Counters that describe how the pairs were computed.
+    */
+    struct Stats {
+        // Number of pairs.
+        long long pairs = 0;
+        // Number of pairs computed in lanes.
+        long long batched = 0;
+        // Number of batches run.
+        long long batches = 0;
+        // Number of pairs computed one at a time.
+        long long scalar = 0;
+    };
+
+    /**
+     * Computes the TED between the trees of every pair.
+     *
+     * Batches and the remaining pairs are spread over a pool of threads.
+     *
+     * @param pairs The pairs of ordered labeled rooted trees to compare
+     * @param stats Counters that will be updated with the work done
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     *
+     * @returns The distance of every pair, in the same order
+    */
+    std::vector<int> ted(const std::vector<std::pair<Tree, Tree>>& pairs, Stats& stats, int threads = 0);
+
+    /**
+     * Computes the TED of up to LANES pairs whose trees have the same shapes, that is every T1 has the same
+     * parent for every node, and so does every T2.
+     *
+     * It requires O(n^4) vector steps, the same as ZhangShasha does for a single pair.
+     *
+     * @param t1 The first tree of every pair
+     * @param t2 The second tree of every pair
+     * @param d The distance of every pair
+     * @param count The number of pairs, at most LANES
+    */
+    void ted_lanes(const Tree* const* t1, const Tree* const* t2, int* d, int count);
+}
+
+#endif
@@ -0,0 +1,213 @@
+#include <boundedTed.h>
+#include <zhangShasha.h>
+#include <scratch.h>
+#include <algorithm>
+#include <cctype>
+#include <vector>
+
+namespace {
+    /**
+     * Finds the last row that reads every row of the forest distance table of keyroot k, and returns the number
+     * of rows that are alive at once.
+     *
+     * Rows are filled from rk down to k. Row x is read by row x - 1 and by every row i with rl(i) + 1 = x, so the
+     * last reader is the smallest of them.
+    */
+    int plan(int k, const std::vector<int>& rl, std::vector<int>& last) {
+        int rk = rl[k];
+
+        for (int i = rk; i >= k; --i) {
+            last[i + 1] = i;
+            last[rl[i] + 1] = i;
+        }
+
+        int live = 1;
+        int peak = 1;
+
+        for (int i = rk; i >= k; --i) {
+            peak = std::max(peak, ++live);
+
+            if (last[i + 1] == i) {
+                --live;
+            }
+
+            if (rl[i] != i && last[rl[i] + 1] == i) {
+                --live;
+            }
+        }
+
+        return peak;
+    }
+
+    template <typename Cell>
+    int fill(const Tree& t1, const Tree& t2, std::size_t max_memory, const std::string& dir, BoundedTed::Stats& stats) {
+        int n = t1.n;
+        int m = t2.n;
+
+        std::vector<int> rl1 = t1.rightmost();
+        std::vector<int> rl2 = t2.rightmost();
+
+        // Keyroots are processed in decreasing order so that the pairs below them are done first
+        std::vector<int> kr1 = t1.keyroots_r();
+        std::reverse(kr1.begin(), kr1.end());
+        std::vector<int> kr2 = t2.keyroots_r();
+        std::reverse(kr2.begin(), kr2.end());
+
+        std::vector<int> last(n + 2);
+
+        // The root keyroot spans every row, so no other keyroot keeps more rows alive
+        int rows = plan(1, rl1, last);
+
+        stats.td_bytes = sizeof(Cell) * static_cast<std::size_t>(n) * m;
+        stats.fd_bytes = sizeof(Cell) * static_cast<std::size_t>(rows) * (m + 1);
+
+        // The subtree distance table is the largest and the least often visited, so it is the first one to go
+        stats.td_spilled = max_memory > 0 && stats.td_bytes + stats.fd_bytes > max_memory;
+        stats.fd_spilled = max_memory > 0 && stats.fd_bytes > max_memory;
+
+        Scratch td_memory(stats.td_bytes, stats.td_spilled, dir);
+        Scratch fd_memory(stats.fd_bytes, stats.fd_spilled, dir);
+
+        // td(i, j) is stored at (n - i, m - j), since both i and j are visited in decreasing order
+        Cell* td = static_cast<Cell*>(td_memory.data());
+        Cell* pool = static_cast<Cell*>(fd_memory.data());
+
+        auto td_row = [&](int i) {
+            return td + static_cast<std::size_t>(n - i) * m + m;
+        };
+
+        // Rows of the forest distance table that are not in use, and the row each slot holds
+        std::vector<int> free_slots;
+        std::vector<Cell*> row(n + 2, nullptr);
+
+        for (int k: kr1) {
+            int rk = rl1[k];
+
+            plan(k, rl1, last);
+
+            for (int l: kr2) {
+                int rl = rl2[l];
+
+                free_slots.clear();
+                for (int s = rows - 1; s >= 0; --s) {
+                    free_slots.push_back(s);
+                }
+
+                // fd[x][j] is stored at offset rl + 1 - j of the slot of row x
+                auto take = [&](int x) {
+                    row[x] = pool + static_cast<std::size_t>(free_slots.back()) * (m + 1) + rl + 1;
+                    free_slots.pop_back();
+                };
+
+                auto give = [&](int x) {
+                    free_slots.push_back((row[x] - rl - 1 - pool) / (m + 1));
+                };
+
+                take(rk + 1);
+
+                Cell* base = row[rk + 1];
+                for (int j = rl + 1, d = 0; j >= l; --j, ++d) {
+                    base[-j] = d;
+                }
+
+                for (int i = rk; i >= k; --i) {
+                    take(i);
+
+                    Cell* current = row[i];
+                    const Cell* below = row[i + 1];
+                    const Cell* far = row[rl1[i] + 1];
+                    Cell* distances = td_row(i);
+
+                    bool path = rl1[i] == rk;
+                    int label = t1.labels[i];
+
+                    int right = below[-(rl + 1)] + 1;
+                    current[-(rl + 1)] = right;
+
+                    for (int j = rl; j >= l; --j) {
+                        int d = std::min(static_cast<int>(below[-j]), right) + 1;
+
+                        if (path && rl2[j] == rl) {
+                            d = std::min(d, below[-(j + 1)] + (label == t2.labels[j] ? 0 : 1));
+                            distances[-j] = d;
+                        } else {
+                            d = std::min(d, far[-(rl2[j] + 1)] + distances[-j]);
+                        }
+
+                        current[-j] = d;
+                        right = d;
+                    }
+
+                    if (last[i + 1] == i) {
+                        give(i + 1);
+                    }
+
+                    if (rl1[i] != i && last[rl1[i] + 1] == i) {
+                        give(rl1[i] + 1);
+                    }
+                }
+            }
+        }
+
+        return td_row(1)[-1];
+    }
+}
+
+int BoundedTed::ted(const Tree& t1, const Tree& t2, std::size_t max_memory, const std::string& dir, Stats& stats) {
+    stats = Stats();
+
+    if (t1.n == 0 || t2.n == 0) {
+        return t1.n + t2.n;
+    }
+
+    // The distance is symmetric, so keep the rows of the tree that needs fewer of them alive at once
+    std::vector<int> last1(t1.n + 2);
+    std::vector<int> last2(t2.n + 2);
+
+    long long rows1 = static_cast<long long>(plan(1, t1.rightmost(), last1)) * (t2.n + 1);
+    long long rows2 = static_cast<long long>(plan(1, t2.rightmost(), last2)) * (t1.n + 1);
+
+    const Tree& a = rows1 <= rows2 ? t1 : t2;
+    const Tree& b = rows1 <= rows2 ? t2 : t1;
+
+    return ZhangShasha::with_cell(t1.n + t2.n, [&](auto cell) -> int {
+        return fill<decltype(cell)>(a, b, max_memory, dir, stats);
+    });
+}
+
+bool BoundedTed::parse_size(const std::string& text, std::size_t& bytes) {
+    std::size_t end = 0;
+    unsigned long long value;
+
+    try {
+        value = std::stoull(text, &end);
+    } catch (const std::exception&) {
+        return false;
+    }
+
+    if (end == text.size()) {
+        bytes = value;
+        return true;
+    }
+
+    if (end + 1 != text.size()) {
+        return false;
+    }
+
+    switch (std::toupper(text[end])) {
+        case 'G':
+            value <<= 10;
+            // fall through
+        case 'M':
+            value <<= 10;
+            // fall through
+        case 'K':
+            value <<= 10;
+            break;
+        default:
+            return false;
+    }
+
+    bytes = value;
+    return true;
+}
@@ -0,0 +1,62 @@
+#ifndef BOUNDEDTED_H
+#define BOUNDEDTED_H
+
+#include <tree.h>
+#include <cstddef>
+#include <string>
+
+/**
+ * Computes the exact Tree Edit Distance (TED) between trees too large for the tables of ZhangShasha to fit in
+ * memory.
+ *
+ * The subtree distance table is needed in full until the last keyroot pair, since the root keyroot reads the
+ * distance of every subtree that is not on its rightmost path. The forest distance table of a keyroot pair is
+ * not. Its row i only reads row i + 1 and the row after the rightmost leaf of i, so once a row has no reader
+ * left it is recycled, and only as many rows as the depth of the tree stay alive rather than one per node.
+ *
+ * When the tables still exceed the memory budget, they are backed by a temporary file mapped into memory. Both
+ * tables are laid out in the order the keyroot pairs visit them, so the file is read and written front to back.
+*/
+namespace BoundedTed {
+    /**
+     * Counters that describe the memory used by a computation.
+    */
+    struct Stats {
+        // Size of the subtree distance table.
+        std::size_t td_bytes = 0;
+        // Size of the rows of the forest distance table that are alive at once.
+        std::size_t fd_bytes = 0;
+        // Whether each table was backed by a file.
+        bool td_spilled = false;
+        bool fd_spilled = false;
+    };
+
+    /**
+     * Computes the TED between T1 and T2 with ZhangShasha within a memory budget.
+     *
+     * It requires O(n^2 m^2) time in the worst case like ZhangShasha, and O(nm + dm) memory where d is the depth
+     * of the tree whose forest rows are kept, part of which is moved to disk when it exceeds the budget.
+     *
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param max_memory The number of bytes the tables may take in memory, or 0 for no limit
+     * @param dir The directory where scratch files are created
+     * @param stats Counters that will be filled in with the memory used
+     *
+     * @returns An integer that represents the number of operations needed to transform t1 into t2.
+     * Each operation has unit cost.
+    */
+    int ted(const Tree& t1, const Tree& t2, std::size_t max_memory, const std::string& dir, Stats& stats);
+
+    /**
+     * Parses a number of bytes with an optional suffix K, M or G, such as 512M.
+     *
+     * @param text The text to parse
+     * @param bytes The number of bytes, which is only set when the text is valid
+     *
+     * @returns Whether the text is a valid size
+    */
+    bool parse_size(const std::string& text, std::size_t& bytes);
+}
+
+#endif
@@ -0,0 +1,46 @@
+#include <bounds.h>
+#include <algorithm>
+
+Bounds::Signature Bounds::signature(const Tree& t) {
+    std::vector<int> labels(t.labels.begin() + std::min<int>(1, t.labels.size()), t.labels.end());
+    std::sort(labels.begin(), labels.end());
+
+    Signature s;
+    s.n = t.n;
+
+    for (int label: labels) {
+        if (s.histogram.empty() || s.histogram.back().first != label) {
+            s.histogram.push_back({label, 0});
+        }
+
+        ++s.histogram.back().second;
+    }
+
+    return s;
+}
+
+int Bounds::lower_bound(const Signature& s1, const Signature& s2) {
+    // excess of T1 over T2 and excess of T2 over T1
+    int e1 = 0;
+    int e2 = 0;
+
+    int i = 0, j = 0;
+
+    while (i < s1.histogram.size() || j < s2.histogram.size()) {
+        if (j == s2.histogram.size() || (i < s1.histogram.size() && s1.histogram[i].first < s2.histogram[j].first)) {
+            e1 += s1.histogram[i++].second;
+        } else if (i == s1.histogram.size() || s2.histogram[j].first < s1.histogram[i].first) {
+            e2 += s2.histogram[j++].second;
+        } else {
+            int d = s1.histogram[i++].second - s2.histogram[j++].second;
+
+            if (d > 0) {
+                e1 += d;
+            } else {
+                e2 -= d;
+            }
+        }
+    }
+
+    return std::max(e1, e2);
+}
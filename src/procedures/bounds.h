@@ -0,0 +1,48 @@
+#ifndef BOUNDS_H
+#define BOUNDS_H
+
+#include <tree.h>
+#include <vector>
+#include <utility>
+
+namespace Bounds {
+    /**
+     * A summary of T that is cheap to compare against the summary of another tree.
+    */
+    struct Signature {
+        // Number of nodes in T.
+        int n;
+
+        // Pairs of label and number of nodes in T with that label, sorted by label.
+        std::vector<std::pair<int, int>> histogram;
+    };
+
+    /**
+     * Computes the label histogram signature of T.
+     * 
+     * It requires O(nlgn) time.
+     * 
+     * @param t An ordered labeled rooted tree
+     * 
+     * @returns The signature of T
+    */
+    Signature signature(const Tree& t);
+
+    /**
+     * Computes a lower bound for the Tree Edit Distance (TED) between T1 and T2 from their label histograms.
+     * 
+     * Every operation changes the count of at most one label in T1 that is in excess of T2, and of at most
+     * one label in T2 that is in excess of T1. As such, the number of operations is at least the largest of
+     * both excesses. This bound also dominates the difference in size between T1 and T2.
+     * 
+     * It requires O(a + b) time where a and b are the number of distinct labels in T1 and T2.
+     * 
+     * @param s1 The signature of T1
+     * @param s2 The signature of T2
+     * 
+     * @returns A number that is never greater than the tree edit distance between T1 and T2
+    */
+    int lower_bound(const Signature& s1, const Signature& s2);
+}
+
+#endif
@@ -0,0 +1,168 @@
+#include <constrained.h>
+#include <subtreeTable.h>
+#include <workspace.h>
+#include <algorithm>
+#include <limits>
+#include <vector>
+
+int Constrained::ted(const Tree& t1, const Tree& t2) {
+    return Constrained::ted(t1, t2, CancelToken());
+}
+
+int Constrained::ted(const Tree& t1, const Tree& t2, const CancelToken& token) {
+    int n = t1.n;
+    int m = t2.n;
+
+    if (n == 0 || m == 0) {
+        return n + m;
+    }
+
+    const int INF = std::numeric_limits<int>::max() / 2;
+
+    // Size of the subtree rooted at any node. It is also the cost of deleting or inserting the whole subtree.
+    std::vector<int> size1 = t1.size_subtrees();
+    std::vector<int> size2 = t2.size_subtrees();
+
+    // Children of every node of T2 laid out contiguously, since the rows of T1 sweep over all of them
+    std::vector<int> first(m + 2);
+    std::vector<int> children;
+    children.reserve(m);
+
+    for (int j = 1; j <= m; ++j) {
+        first[j] = children.size();
+        children.insert(children.end(), t2.adj[j].begin(), t2.adj[j].end());
+    }
+
+    first[m + 1] = children.size();
+
+    // The distances of a subtree of T1 only depend on its labels and shape, so identical subtrees share them
+    SubtreeTable table;
+    std::vector<int> id = table.canonical(t1);
+
+    // Number of nodes with a given id whose parent still needs their row
+    std::vector<int> pending(table.ids.size());
+    for (int i = 2; i <= n; ++i) {
+        ++pending[id[i]];
+    }
+
+    // dt[x][j] corresponds to the distance between the subtree of T1 with id x and the subtree T2 rooted at j
+    // df[x][j] corresponds to the distance between their forests of children
+    //
+    // dt[i][j] = min(
+    //      size(j) + min over children jt of j (dt[i][jt] - size(jt)),
+    //      size(i) + min over children is of i (dt[is][j] - size(is)),
+    //      df[i][j] + cost of relabeling T1[i] to T2[j]
+    // );
+    //
+    // df[i][j] = min(
+    //      size(j) - 1 + min over children jt of j (df[i][jt] - size(jt) + 1),
+    //      size(i) - 1 + min over children is of i (df[is][j] - size(is) + 1),
+    //      alignment of the children of i and j where each child is a single symbol
+    // );
+    //
+    // Rows of T1 are filled in reverse pre-order, so the rows of the children of i are ready when i is processed.
+    // A row is released once every parent of a subtree with its id is done.
+    std::vector<std::vector<int>> dt(table.ids.size());
+    std::vector<std::vector<int>> df(table.ids.size());
+
+    // Alignments of the children of i and j are only kept while a single cell is filled, so they are taken from the
+    // arena of the thread like the forest tables of ZhangShasha
+    Workspace& ws = Workspace::local();
+
+    for (int i = n; i >= 1; --i) {
+        // A row takes O(m) time at least, so the clock is cheap next to it
+        if (token.expired()) {
+            return -1;
+        }
+
+        int x = id[i];
+        const std::vector<int>& ci = t1.adj[i];
+
+        auto release_children = [&]() {
+            for (int is: ci) {
+                if (--pending[id[is]] == 0) {
+                    std::vector<int>().swap(dt[id[is]]);
+                    std::vector<int>().swap(df[id[is]]);
+                }
+            }
+        };
+
+        if (!dt[x].empty()) {
+            release_children();
+            continue;
+        }
+
+        int a_size = ci.size();
+
+        dt[x].assign(m + 1, INF);
+        df[x].assign(m + 1, INF);
+
+        int* t_row = dt[x].data();
+        int* f_row = df[x].data();
+
+        for (int j = m; j >= 1; --j) {
+            const int* cj = children.data() + first[j];
+            int b_size = first[j + 1] - first[j];
+
+            int t = INF;
+            int f = INF;
+
+            for (int b = 0; b < b_size; ++b) {
+                int jt = cj[b];
+
+                t = std::min(t, size2[j] + t_row[jt] - size2[jt]);
+                f = std::min(f, size2[j] - 1 + f_row[jt] - size2[jt] + 1);
+            }
+
+            for (int is: ci) {
+                t = std::min(t, size1[i] + dt[id[is]][j] - size1[is]);
+                f = std::min(f, size1[i] - 1 + df[id[is]][j] - size1[is] + 1);
+            }
+
+            // String edit distance between the children of i and j, where substituting is by dt, and deleting
+            // or inserting a child removes its whole subtree
+            if (a_size == 0 || b_size == 0) {
+                f = std::min(f, size1[i] - 1 + size2[j] - 1);
+            } else if (a_size == 1 && b_size == 1) {
+                // a single child on both sides is either mapped, or deleted and the other one inserted
+                f = std::min(f, std::min(dt[id[ci[0]]][cj[0]], size1[ci[0]] + size2[cj[0]]));
+            } else {
+                // align[a][b] corresponds to the alignment of the first a children of i and the first b of j
+                Workspace::Mark mark = ws.mark();
+                Workspace::Table<int> align = ws.table<int>(0, a_size, 0, b_size);
+
+                align[0][0] = 0;
+                for (int b = 1; b <= b_size; ++b) {
+                    align[0][b] = align[0][b - 1] + size2[cj[b - 1]];
+                }
+
+                for (int a = 1; a <= a_size; ++a) {
+                    Workspace::Table<int>::Row prev = align[a - 1];
+                    Workspace::Table<int>::Row cur = align[a];
+                    const int* sub = dt[id[ci[a - 1]]].data();
+                    int del = size1[ci[a - 1]];
+
+                    cur[0] = prev[0] + del;
+                    for (int b = 1; b <= b_size; ++b) {
+                        cur[b] = std::min({
+                            prev[b] + del, // delete
+                            cur[b - 1] + size2[cj[b - 1]], // insert
+                            prev[b - 1] + sub[cj[b - 1]] // map
+                        });
+                    }
+                }
+
+                f = std::min(f, align[a_size][b_size]);
+
+                ws.release(mark);
+            }
+
+            t_row[j] = std::min(t, f + (t1.labels[i] == t2.labels[j] ? 0 : 1));
+            f_row[j] = f;
+        }
+
+        release_children();
+    }
+
+    return dt[id[1]][1];
+}
@@ -0,0 +1,42 @@
+#ifndef CONSTRAINED_H
+#define CONSTRAINED_H
+
+#include <tree.h>
+#include <cancelToken.h>
+
+namespace Constrained {
+    /**
+     * Computes the constrained edit distance between T1 and T2 using the algorithm described by Zhang in 1995
+     * in the paper Algorithms for the Constrained Editing Distance between Ordered Labeled Trees and Related
+     * Problems.
+     * 
+     * A constrained mapping requires that disjoint subtrees are mapped to disjoint subtrees. Every constrained
+     * mapping is a valid mapping, so this distance is never smaller than the Tree Edit Distance (TED) and is often
+     * equal to it. It can be used as a fast answer where constrained mappings are acceptable, or as an upper bound
+     * for TED.
+     * 
+     * It requires O(nm) time where n and m are the number of nodes in T1 and T2. Only the rows of the nodes of T1
+     * whose parent is not processed yet are kept in memory.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * 
+     * @returns An integer that represents the number of operations needed to transform t1 into t2 under a
+     * constrained mapping. Each operation has unit cost.
+    */
+    int ted(const Tree& t1, const Tree& t2);
+
+    /**
+     * Computes the constrained edit distance between T1 and T2 like ted does, but gives up as soon as the token
+     * expires. The token is checked before every node of T1.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param token The token that tells when to stop
+     * 
+     * @returns The constrained edit distance between t1 and t2, or -1 if the token expired first
+    */
+    int ted(const Tree& t1, const Tree& t2, const CancelToken& token);
+}
+
+#endif
@@ -0,0 +1,106 @@
+#include <incrementalTed.h>
+#include <zhangShasha.h>
+#include <unordered_map>
+
+namespace {
+    /**
+     * Counts the cells of the forest distance tables filled for the given keyroots of T1 against T2, where rl1
+     * holds the rightmost leaf of every node of T1.
+    */
+    long long cells(const std::vector<int>& rl1, const std::vector<int>& keyroots, const Tree& t2) {
+        std::vector<int> rl2 = t2.rightmost();
+
+        long long c1 = 0, c2 = 0;
+
+        for (int k: keyroots) {
+            c1 += rl1[k] - k + 2;
+        }
+
+        for (int l: t2.keyroots_r()) {
+            c2 += rl2[l] - l + 2;
+        }
+
+        return c1 * c2;
+    }
+}
+
+IncrementalTED::IncrementalTED(const Tree& t1, const Tree& t2) : t1(t1), t2(t2) {
+    td = ZhangShasha::ted_complete(t2, t1);
+    ids = table.canonical(t2);
+
+    std::vector<int> keyroots = t2.keyroots_r();
+
+    stats.changed = t2.n;
+    stats.keyroots = keyroots.size();
+    stats.full_cells = cells(t2.rightmost(), keyroots, t1);
+    stats.cells = stats.full_cells;
+}
+
+int IncrementalTED::distance() const {
+    return td[1][1];
+}
+
+int IncrementalTED::update(const Tree& next) {
+    std::vector<int> next_ids = table.canonical(next);
+
+    // Any node of the previous version with the same canonical id can give its distances away
+    std::unordered_map<int, int> previous;
+    for (int j = 1; j <= t2.n; ++j) {
+        previous.insert({ids[j], j});
+    }
+
+    std::vector<std::vector<int>> next_td(next.n + 1);
+    std::vector<bool> changed(next.n + 1);
+
+    // Nodes of the new version that already own the distances for a canonical id
+    std::unordered_map<int, int> owner;
+
+    stats = Stats();
+
+    for (int j = 1; j <= next.n; ++j) {
+        auto it = owner.find(next_ids[j]);
+
+        if (it != owner.end()) {
+            next_td[j] = next_td[it->second];
+            ++stats.reused;
+            continue;
+        }
+
+        auto p = previous.find(next_ids[j]);
+
+        if (p != previous.end()) {
+            next_td[j] = std::move(td[p->second]);
+            owner.insert({next_ids[j], j});
+            ++stats.reused;
+        } else {
+            next_td[j] = std::vector<int>(t1.n + 1, -1);
+            changed[j] = true;
+            ++stats.changed;
+        }
+    }
+
+    // A keyroot runs again if its rightmost path holds a changed node. Since changed nodes are closed under
+    // ancestors, it is enough to check the keyroot itself.
+    std::vector<int> keyroots;
+    for (int l: next.keyroots_r()) {
+        if (changed[l]) {
+            keyroots.push_back(l);
+        }
+    }
+
+    std::vector<int> keyroots_desc(keyroots.rbegin(), keyroots.rend());
+
+    ZhangShasha::ted_partial(next, t1, keyroots_desc, next_td);
+
+    std::vector<int> rl = next.rightmost();
+
+    stats.keyroots = keyroots.size();
+    stats.cells = cells(rl, keyroots, t1);
+    stats.full_cells = cells(rl, next.keyroots_r(), t1);
+
+    t2 = next;
+    td = std::move(next_td);
+    ids = std::move(next_ids);
+
+    return distance();
+}
@@ -0,0 +1,76 @@
+#ifndef INCREMENTALTED_H
+#define INCREMENTALTED_H
+
+#include <tree.h>
+#include <subtreeTable.h>
+#include <vector>
+
+/**
+ * Keeps the Tree Edit Distance (TED) between T1 and every subtree of T2 so that it can be updated when T2
+ * receives local edits, rather than being computed from scratch.
+ * 
+ * A subtree of the new T2 that is identical to a subtree of the previous T2 has the same distance to every
+ * subtree of T1, so its distances are reused. Only the subtrees that changed, which are the ancestors of the
+ * edited nodes, are computed again with ZhangShasha. The keyroots of T2 that have to run again are the ones
+ * whose rightmost path holds a changed node.
+ * 
+ * Since TED is symmetric, distances are kept with T2 as the first tree, so that reusing the distances of a
+ * subtree of T2 only moves a row.
+*/
+struct IncrementalTED {
+    /**
+     * Counters that describe the work done by the last computation.
+    */
+    struct Stats {
+        // Number of nodes of T2 whose distances were reused.
+        int reused = 0;
+        // Number of nodes of T2 whose subtree changed.
+        int changed = 0;
+        // Number of keyroots of T2 that were run again.
+        int keyroots = 0;
+        // Number of cells of the forest distance tables that were filled.
+        long long cells = 0;
+        // Number of cells of the forest distance tables a computation from scratch would fill.
+        long long full_cells = 0;
+    };
+
+    // The tree that stays fixed.
+    Tree t1;
+
+    // The tree that receives edits.
+    Tree t2;
+
+    // td[j][i] corresponds to the TED between the subtree of T2 rooted at j and the subtree of T1 rooted at i.
+    std::vector<std::vector<int>> td;
+
+    // Assigns canonical ids to the subtrees of every version of T2.
+    SubtreeTable table;
+
+    // Canonical id of every subtree of T2.
+    std::vector<int> ids;
+
+    // Work done by the last computation.
+    Stats stats;
+
+    /**
+     * Computes the distances between every subtree of T1 and T2 from scratch.
+    */
+    IncrementalTED(const Tree& t1, const Tree& t2);
+
+    /**
+     * Gets the tree edit distance between T1 and T2.
+    */
+    int distance() const;
+
+    /**
+     * Replaces T2 with a new version and updates the distances. The cost is proportional to the subtrees of the
+     * new version that do not appear in the previous one.
+     * 
+     * @param t2 The new version of T2
+     * 
+     * @returns The tree edit distance between T1 and the new version of T2
+    */
+    int update(const Tree& t2);
+};
+
+#endif
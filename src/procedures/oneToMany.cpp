@@ -0,0 +1,120 @@
+#include <oneToMany.h>
+#include <zhangShasha.h>
+#include <shapes.h>
+#include <parallel.h>
+#include <workspace.h>
+#include <atomic>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+OneToMany::Query::Query(const Tree& t) : prepared(t), signature(Bounds::signature(t)) {
+    path = Shapes::is_path(t);
+    star = Shapes::is_star(t);
+}
+
+int OneToMany::ted(const Query& q, const Tree& t) {
+    const Tree& query = q.prepared.tree;
+
+    if (query.n == 0 || t.n == 0) {
+        return query.n + t.n;
+    }
+
+    // The same fast paths as Shapes::ted, with the shape of the query taken from the flags computed once for it
+    bool path = Shapes::is_path(t);
+
+    if (q.path && path) {
+        return Shapes::sed(std::vector<int>(query.labels.begin() + 1, query.labels.end()),
+                           std::vector<int>(t.labels.begin() + 1, t.labels.end()));
+    }
+
+    if (q.path) {
+        return Shapes::path_ted(query, t);
+    }
+
+    if (path) {
+        return Shapes::path_ted(t, query);
+    }
+
+    if (q.star && Shapes::is_star(t)) {
+        return Shapes::star_ted(query, t);
+    }
+
+    return ZhangShasha::ted(q.prepared, PreparedTree(t), Workspace::local());
+}
+
+void OneToMany::run(
+    const Query& q,
+    std::istream& in,
+    const Options& options,
+    Stats& stats,
+    const std::function<void(long long, int)>& emit
+) {
+    int tau = options.tau;
+
+    std::vector<std::string> lines;
+    // Line of the stream every candidate of the chunk was read from
+    std::vector<long long> at;
+    std::vector<int> d;
+
+    // Number of lines read from the stream, empty ones included
+    long long position = 0;
+    bool more = true;
+
+    while (more && !stats.stopped) {
+        lines.clear();
+        at.clear();
+
+        std::string line;
+        while (lines.size() < CHUNK && (more = static_cast<bool>(std::getline(in, line)))) {
+            if (!line.empty() && line.back() == '\r') {
+                line.pop_back();
+            }
+
+            if (!line.empty()) {
+                lines.push_back(line);
+                at.push_back(position);
+            }
+
+            ++position;
+        }
+
+        d.assign(lines.size(), -1);
+
+        std::atomic<long long> pruned(0), verified(0);
+
+        Parallel::for_each(lines.size(), [&](int i) {
+            Tree t(lines[i]);
+
+            if (tau >= 0) {
+                int n = q.prepared.tree.n;
+
+                if (std::abs(t.n - n) > tau || Bounds::lower_bound(q.signature, Bounds::signature(t)) > tau) {
+                    ++pruned;
+                    return;
+                }
+            }
+
+            ++verified;
+            d[i] = ted(q, t);
+        }, options.threads);
+
+        stats.candidates += lines.size();
+        stats.pruned += pruned;
+        stats.verified += verified;
+
+        for (int i = 0; i < lines.size(); ++i) {
+            if (d[i] < 0 || (tau >= 0 && d[i] > tau)) {
+                continue;
+            }
+
+            emit(at[i], d[i]);
+            ++stats.matches;
+
+            if (options.k > 0 && stats.matches >= options.k) {
+                stats.stopped = true;
+                break;
+            }
+        }
+    }
+}
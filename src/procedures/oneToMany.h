@@ -0,0 +1,95 @@
+#ifndef ONETOMANY_H
+#define ONETOMANY_H
+
+#include <tree.h>
+#include <preparedTree.h>
+#include <bounds.h>
+#include <functional>
+#include <istream>
+
+/**
+ * Compares one query tree against a stream of candidate trees.
+ *
+ * The query is prepared once, so its structural arrays, its label histogram and whether it is a path or a star are
+ * not derived again for every candidate. Candidates are read in chunks and compared in parallel, each thread taking
+ * its tables from its own workspace, which keeps the memory of the largest candidate seen so far rather than
+ * reaching the system allocator again.
+*/
+namespace OneToMany {
+    /**
+     * A query tree along with everything derived from it.
+    */
+    struct Query {
+        PreparedTree prepared;
+        Bounds::Signature signature;
+        // Whether every node of the query has at most one child.
+        bool path;
+        // Whether every child of the root of the query is a leaf.
+        bool star;
+
+        /**
+         * Prepares a query tree.
+        */
+        Query(const Tree& t);
+    };
+
+    /**
+     * Tells which candidates are reported and when to stop.
+    */
+    struct Options {
+        // Largest distance of a match, or -1 to report every candidate.
+        int tau = -1;
+        // Number of matches after which no more candidates are read, or 0 to read every candidate.
+        int k = 0;
+        // Number of threads. If it is not positive, all hardware threads are used.
+        int threads = 0;
+    };
+
+    /**
+     * Counters that describe the work done.
+    */
+    struct Stats {
+        // Number of candidates read.
+        long long candidates = 0;
+        // Number of candidates discarded by their size or label histogram.
+        long long pruned = 0;
+        // Number of candidates whose distance was computed.
+        long long verified = 0;
+        // Number of matches reported.
+        long long matches = 0;
+        // Whether k matches were found, after which no more candidates were read.
+        bool stopped = false;
+    };
+
+    // Number of candidates read and compared at once.
+    const int CHUNK = 1024;
+
+    /**
+     * Computes the Tree Edit Distance (TED) between the query and a single candidate.
+    */
+    int ted(const Query& q, const Tree& t);
+
+    /**
+     * Compares the query against every candidate read from a stream, one pre-order traversal per line. Empty lines
+     * are skipped, but they are counted, so the position of a candidate is the zero-based number of its line.
+     *
+     * Candidates further than tau from the query are skipped without computing their distance whenever their size
+     * or label histogram tells so. Matches are reported in the order of the stream, and once k of them are found no
+     * more candidates are reported or read.
+     *
+     * @param q The prepared query
+     * @param in The stream of candidates
+     * @param options What to report and when to stop
+     * @param stats Counters that will be updated with the work done
+     * @param emit Called with the zero-based position of every match in the stream and its distance
+    */
+    void run(
+        const Query& q,
+        std::istream& in,
+        const Options& options,
+        Stats& stats,
+        const std::function<void(long long, int)>& emit
+    );
+}
+
+#endif
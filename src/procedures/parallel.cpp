@@ -0,0 +1,227 @@
+#include <parallel.h>
+#include <thread>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <deque>
+#include <mutex>
+#include <condition_variable>
+
+int Parallel::threads() {
+    int t = std::thread::hardware_concurrency();
+
+    return t > 0 ? t : 1;
+}
+
+void Parallel::for_each(int count, const std::function<void(int)>& fn, int threads) {
+    if (threads <= 0) {
+        threads = Parallel::threads();
+    }
+
+    threads = std::min(threads, count);
+
+    std::atomic<int> next(0);
+
+    auto worker = [&]() {
+        for (int i = next++; i < count; i = next++) {
+            fn(i);
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker);
+    }
+
+    worker();
+
+    for (auto& t: pool) {
+        t.join();
+    }
+}
+
+void Parallel::run_graph(const std::vector<std::vector<int>>& dependents, const std::function<void(int)>& fn, int threads) {
+    int count = dependents.size();
+
+    if (count == 0) {
+        return;
+    }
+
+    if (threads <= 0) {
+        threads = Parallel::threads();
+    }
+
+    threads = std::min(threads, count);
+
+    // Number of dependencies of every task that are not done yet
+    std::vector<std::atomic<int>> waiting(count);
+    for (int u = 0; u < count; ++u) {
+        for (int v: dependents[u]) {
+            ++waiting[v];
+        }
+    }
+
+    // Ready tasks of every thread, each behind its own lock
+    std::vector<std::deque<int>> queues(threads);
+    std::vector<std::mutex> locks(threads);
+
+    for (int u = 0, t = 0; u < count; ++u) {
+        if (waiting[u] == 0) {
+            queues[t].push_back(u);
+            t = (t + 1) % threads;
+        }
+    }
+
+    // Idle threads sleep until a task is pushed or every task is done
+    std::mutex idle;
+    std::condition_variable wake;
+    int ready = 0;
+    int remaining = count;
+
+    for (const auto& q: queues) {
+        ready += q.size();
+    }
+
+    auto take = [&](int t) {
+        int u = -1;
+
+        {
+            std::lock_guard<std::mutex> lock(locks[t]);
+
+            if (!queues[t].empty()) {
+                u = queues[t].back();
+                queues[t].pop_back();
+            }
+        }
+
+        for (int o = 1; u == -1 && o < threads; ++o) {
+            int victim = (t + o) % threads;
+            std::lock_guard<std::mutex> lock(locks[victim]);
+
+            if (!queues[victim].empty()) {
+                u = queues[victim].front();
+                queues[victim].pop_front();
+            }
+        }
+
+        if (u != -1) {
+            std::lock_guard<std::mutex> lock(idle);
+            --ready;
+        }
+
+        return u;
+    };
+
+    auto worker = [&](int t) {
+        while (true) {
+            int u = take(t);
+
+            if (u == -1) {
+                std::unique_lock<std::mutex> lock(idle);
+                wake.wait(lock, [&]() { return ready > 0 || remaining == 0; });
+
+                if (remaining == 0) {
+                    return;
+                }
+
+                continue;
+            }
+
+            fn(u);
+
+            int pushed = 0;
+            for (int v: dependents[u]) {
+                if (--waiting[v] == 0) {
+                    std::lock_guard<std::mutex> lock(locks[t]);
+                    queues[t].push_back(v);
+                    ++pushed;
+                }
+            }
+
+            std::lock_guard<std::mutex> lock(idle);
+            ready += pushed;
+
+            // This thread goes on with one of the tasks it pushed, so others are only woken up for the rest
+            if (--remaining == 0 || pushed > 1) {
+                wake.notify_all();
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    for (int t = 1; t < threads; ++t) {
+        pool.emplace_back(worker, t);
+    }
+
+    worker(0);
+
+    for (auto& t: pool) {
+        t.join();
+    }
+}
+
+Parallel::Pool::Pool(int threads) {
+    pending = 0;
+    stopping = false;
+
+    if (threads <= 0) {
+        threads = Parallel::threads();
+    }
+
+    for (int t = 0; t < threads; ++t) {
+        workers.emplace_back([this]() {
+            while (true) {
+                std::function<void()> task;
+
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    available.wait(lock, [this]() { return stopping || !tasks.empty(); });
+
+                    if (tasks.empty()) {
+                        return;
+                    }
+
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+
+                task();
+
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--pending == 0) {
+                    done.notify_all();
+                }
+            }
+        });
+    }
+}
+
+Parallel::Pool::~Pool() {
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+
+    available.notify_all();
+
+    for (auto& t: workers) {
+        t.join();
+    }
+}
+
+void Parallel::Pool::submit(std::function<void()> task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.push_back(std::move(task));
+        ++pending;
+    }
+
+    available.notify_one();
+}
+
+void Parallel::Pool::wait() {
+    std::unique_lock<std::mutex> lock(mutex);
+    done.wait(lock, [this]() { return pending == 0; });
+}
@@ -0,0 +1,91 @@
+#ifndef PARALLEL_H
+#define PARALLEL_H
+
+#include <functional>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+
+namespace Parallel {
+    /**
+     * Gets the number of threads to use when the caller does not specify one.
+     * 
+     * @returns The number of hardware threads, or 1 if it cannot be determined
+    */
+    int threads();
+
+    /**
+     * Runs fn(i) for every i in [0, count) on a pool of threads. Indices are handed out dynamically so
+     * that uneven amounts of work per index are balanced across threads.
+     * 
+     * The calling thread takes part in the work and the function returns once every index is done.
+     * 
+     * @param count The number of indices to process
+     * @param fn The work to do for a single index. It must be safe to call it concurrently for different indices
+     * @param threads The number of threads to use. If it is not positive, Parallel::threads() is used
+    */
+    void for_each(int count, const std::function<void(int)>& fn, int threads = 0);
+
+    /**
+     * Runs fn(i) for every task i of a directed acyclic graph on a pool of threads, where a task only starts once
+     * every task it depends on is done.
+     * 
+     * Every thread keeps its own queue of ready tasks. Tasks that become ready are pushed to the queue of the thread
+     * that finished their last dependency, which takes the newest one next since its inputs are likely still in
+     * cache. A thread whose queue is empty steals the oldest task from the queue of another thread.
+     * 
+     * The calling thread takes part in the work and the function returns once every task is done.
+     * 
+     * @param dependents For every task, the tasks that depend on it
+     * @param fn The work to do for a single task. It must be safe to call it concurrently for tasks that do not
+     * depend on each other
+     * @param threads The number of threads to use. If it is not positive, Parallel::threads() is used
+    */
+    void run_graph(const std::vector<std::vector<int>>& dependents, const std::function<void(int)>& fn, int threads = 0);
+
+    /**
+     * A fixed set of threads that run tasks in the order they are submitted.
+     * 
+     * Threads are started when the pool is constructed and live until it is destroyed, so that state owned by
+     * each thread, such as its workspace, is reused across tasks.
+    */
+    struct Pool {
+        /**
+         * Starts the threads of the pool.
+         * 
+         * @param threads The number of threads to start. If it is not positive, Parallel::threads() is used
+        */
+        Pool(int threads = 0);
+
+        /**
+         * Waits for every submitted task and stops the threads.
+        */
+        ~Pool();
+
+        /**
+         * Queues a task to be run by one of the threads.
+        */
+        void submit(std::function<void()> task);
+
+        /**
+         * Waits until every submitted task is done.
+        */
+        void wait();
+
+    private:
+        std::vector<std::thread> workers;
+        std::deque<std::function<void()>> tasks;
+
+        std::mutex mutex;
+        std::condition_variable available;
+        std::condition_variable done;
+
+        // Number of tasks submitted but not finished yet
+        int pending;
+        bool stopping;
+    };
+}
+
+#endif
@@ -0,0 +1,75 @@
+#include <protocol.h>
+
+#ifdef _WIN32
+#include <io.h>
+#define read_fd _read
+#define write_fd _write
+#else
+#include <unistd.h>
+#define read_fd ::read
+#define write_fd ::write
+#endif
+
+namespace {
+    bool read_all(int fd, char* data, std::size_t size) {
+        while (size > 0) {
+            auto r = read_fd(fd, data, size);
+
+            if (r <= 0) {
+                return false;
+            }
+
+            data += r;
+            size -= r;
+        }
+
+        return true;
+    }
+
+    bool write_all(int fd, const char* data, std::size_t size) {
+        while (size > 0) {
+            auto w = write_fd(fd, data, size);
+
+            if (w <= 0) {
+                return false;
+            }
+
+            data += w;
+            size -= w;
+        }
+
+        return true;
+    }
+}
+
+bool Protocol::read_frame(int fd, std::string& message) {
+    unsigned char header[4];
+
+    if (!read_all(fd, reinterpret_cast<char*>(header), sizeof(header))) {
+        return false;
+    }
+
+    unsigned int size = (header[0] << 24) | (header[1] << 16) | (header[2] << 8) | header[3];
+
+    if (size > MAX_FRAME) {
+        return false;
+    }
+
+    message.resize(size);
+
+    return size == 0 || read_all(fd, &message[0], size);
+}
+
+bool Protocol::write_frame(int fd, const std::string& message) {
+    unsigned int size = message.size();
+
+    std::string frame(4, '\0');
+    frame[0] = static_cast<char>((size >> 24) & 0xff);
+    frame[1] = static_cast<char>((size >> 16) & 0xff);
+    frame[2] = static_cast<char>((size >> 8) & 0xff);
+    frame[3] = static_cast<char>(size & 0xff);
+
+    frame += message;
+
+    return write_all(fd, frame.data(), frame.size());
+}
@@ -0,0 +1,37 @@
+#ifndef PROTOCOL_H
+#define PROTOCOL_H
+
+#include <string>
+
+/**
+ * Framing used by the server mode to exchange requests and responses.
+ * 
+ * Every message is a 4 byte unsigned length in network byte order followed by that many bytes of text.
+ * Frames can be read from and written to any file descriptor, such as a socket or the standard streams.
+*/
+namespace Protocol {
+    // Largest message accepted, so that a corrupted length does not exhaust memory.
+    const unsigned int MAX_FRAME = 1u << 30;
+
+    /**
+     * Reads a single frame.
+     * 
+     * @param fd The file descriptor to read from
+     * @param message The text of the frame
+     * 
+     * @returns Whether a complete frame was read. It is false at the end of the stream or on error
+    */
+    bool read_frame(int fd, std::string& message);
+
+    /**
+     * Writes a single frame.
+     * 
+     * @param fd The file descriptor to write to
+     * @param message The text of the frame
+     * 
+     * @returns Whether the whole frame was written
+    */
+    bool write_frame(int fd, const std::string& message);
+}
+
+#endif
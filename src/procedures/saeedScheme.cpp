@@ -1,12 +1,15 @@
 #include <saeedScheme.h>
 #include <zhangShasha.h>
+#include <parallel.h>
 #include <cmath>
 #include <limits>
 #include <cstdint>
 #include <algorithm>
+#include <mutex>
+#include <atomic>
 #include <assert.h>
 
-int SaeedScheme::ted(const Tree& t1_or, const Tree& t2_or) {
+int SaeedScheme::ted(const Tree& t1_or, const Tree& t2_or, int threads, const CancelToken& token, Checkpoints* checkpoints) {
     // Let us first add a dummy root on top each tree by enclosing its preorder traversal in a zero-labeled node
     Tree t1("0(" + t1_or.pre_order() + ")");
     Tree t2("0(" + t2_or.pre_order() + ")");
@@ -34,13 +37,154 @@ int SaeedScheme::ted(const Tree& t1_or, const Tree& t2_or) {
     std::vector<int> t1_rightmost = t1.rightmost();
     std::vector<int> t2_rightmost = t2.rightmost();
 
-    for (auto const& s1: t1_spines) {
-        for (auto const& s2: t2_spines) {
-            SaeedScheme::sed(t1, t2, s1, s2, t1_rightmost, t2_rightmost, d2, td);
+    int spines = t2_spines.size();
+
+    SaeedScheme::run_pairs("Saeed", Checkpoint::hash(t1_or, t2_or), t1, t2, t1_spines, t2_spines, td, threads, token, checkpoints, [&](int pair) {
+        const std::vector<int>& s1 = t1_spines[pair / spines];
+        const std::vector<int>& s2 = t2_spines[pair % spines];
+
+        SaeedScheme::sed(t1, t2, s1, s2, t1_rightmost, t2_rightmost, d2, td, token);
+    });
+
+    return token.cancelled() ? -1 : td[1][1];
+}
+
+void SaeedScheme::run_pairs(
+    const std::string& algorithm,
+    std::uint64_t inputs,
+    const Tree& t1,
+    const Tree& t2,
+    const std::vector<std::vector<int>>& t1_spines,
+    const std::vector<std::vector<int>>& t2_spines,
+    std::vector<std::vector<int>>& td,
+    int threads,
+    const CancelToken& token,
+    Checkpoints* checkpoints,
+    const std::function<void(int)>& sed
+) {
+    std::vector<std::vector<int>> after = SaeedScheme::dependents(t2, t1_spines, t2_spines);
+
+    if (checkpoints == nullptr) {
+        Parallel::run_graph(after, [&](int pair) {
+            if (!token.expired()) {
+                sed(pair);
+            }
+        }, threads);
+
+        return;
+    }
+
+    int spines = t2_spines.size();
+
+    Checkpoint c;
+    c.algorithm = algorithm;
+    c.inputs = inputs;
+    c.rows = t1.n + 1;
+    c.cols = t2.n + 1;
+    c.td.assign(static_cast<std::size_t>(c.rows) * c.cols, 0);
+    c.done.assign(after.size(), false);
+
+    // Copies the distances between the nodes of both spines of a pair from one table to another
+    auto copy = [&](int pair, auto&& from, auto&& to) {
+        for (int u: t1_spines[pair / spines]) {
+            for (int v: t2_spines[pair % spines]) {
+                to(u, v) = from(u, v);
+            }
+        }
+    };
+
+    auto cell = [&](int u, int v) -> int& {
+        return c.td[static_cast<std::size_t>(u) * c.cols + v];
+    };
+
+    auto table = [&](int u, int v) -> int& {
+        return td[u][v];
+    };
+
+    const Checkpoint& resume = checkpoints->resume;
+    if (resume.rows == c.rows && resume.cols == c.cols && resume.done.size() == c.done.size()) {
+        c.td = resume.td;
+        c.done = resume.done;
+
+        for (int pair = 0; pair < c.done.size(); ++pair) {
+            if (c.done[pair]) {
+                copy(pair, cell, table);
+            }
         }
     }
 
-    return td[1][1];
+    // Pairs done before the computation started. Unlike c.done, it is only read while pairs run
+    std::vector<char> resumed(c.done.begin(), c.done.end());
+
+    long long done = std::count(c.done.begin(), c.done.end(), true);
+
+    std::mutex lock;
+    // Whether the limit was reached, after which no pair starts and no finished pair is added to the checkpoint
+    std::atomic<bool> stopped(false);
+
+    Parallel::run_graph(after, [&](int pair) {
+        if (resumed[pair] || token.expired() || stopped) {
+            return;
+        }
+
+        sed(pair);
+
+        if (token.cancelled()) {
+            return;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+
+        if (stopped) {
+            return;
+        }
+
+        copy(pair, table, cell);
+        c.done[pair] = true;
+
+        bool stop = checkpoints->limit >= 0 && ++done >= checkpoints->limit;
+
+        if (stop || checkpoints->due()) {
+            checkpoints->save(c);
+        }
+
+        if (stop) {
+            stopped = true;
+            checkpoints->stopped = done;
+        }
+    }, threads);
+}
+
+std::vector<std::vector<int>> SaeedScheme::dependents(
+    const Tree& t2,
+    const std::vector<std::vector<int>>& t1_spines,
+    const std::vector<std::vector<int>>& t2_spines
+) {
+    int spines = t2_spines.size();
+
+    // Maps every node of T2 to the spine it belongs to
+    std::vector<int> spine(t2.n + 1, -1);
+    for (int b = 0; b < spines; ++b) {
+        for (int v: t2_spines[b]) {
+            spine[v] = b;
+        }
+    }
+
+    std::vector<std::vector<int>> after(t1_spines.size() * spines);
+
+    for (int c = 0; c < spines; ++c) {
+        int p = t2.parent[t2_spines[c].back()];
+
+        if (p == 0) {
+            continue;
+        }
+
+        for (int a = 0; a < t1_spines.size(); ++a) {
+            after[a * spines + c].push_back(a * spines + spine[p]);
+        }
+    }
+
+    return after;
 }
 
 void SaeedScheme::sed(
@@ -51,7 +195,8 @@ void SaeedScheme::sed(
     const std::vector<int>& rl1,
     const std::vector<int>& rl2,
     const std::vector<int>& d2,
-    std::vector<std::vector<int>>& td
+    std::vector<std::vector<int>>& td,
+    const CancelToken& token
 ) {
     /**
      * Let us compute ted for two fixed nodes u and v in s1 and s2 respectively as follows.
@@ -80,6 +225,10 @@ void SaeedScheme::sed(
 
     for (int i = 0; i < s1.size(); ++i) {
         for (int j = 0; j < s2.size(); ++j) {
+            if (token.expired()) {
+                return;
+            }
+
             int L = cost(s1[i], s2[j]);
 
             if (rl1[s1[i]] == s1[i]) {
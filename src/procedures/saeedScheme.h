@@ -2,6 +2,11 @@
 #define SAEEDSCHEME_H
 
 #include <tree.h>
+#include <cancelToken.h>
+#include <checkpoint.h>
+#include <cstdint>
+#include <functional>
+#include <string>
 
 namespace SaeedScheme {
     /**
@@ -10,14 +15,81 @@ namespace SaeedScheme {
      * Distance in Quadratic Time.
      * 
      * It required O(n^6) time. Though it can be improved with some of the ideas in the paper.
+     * 
+     * Spine pairs are scheduled on a pool of threads as soon as the pairs they depend on are done. See dependents.
 
      * @param t1 An ordered labeled rooted tree
      * @param t2 An ordered labeled rooted tree
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     * @param token The token that tells when to stop. It is checked before every pair of nodes of two spines
+     * @param checkpoints The schedule of checkpoints, if any. See run_pairs
+     * 
+     * @returns An integer that represents the number of operations needed to transform t1 into t2, or -1 if the
+     * token expired first. Each operation has unit cost.
+    */
+    int ted(
+        const Tree& t1,
+        const Tree& t2,
+        int threads = 0,
+        const CancelToken& token = CancelToken(),
+        Checkpoints* checkpoints = nullptr
+    );
+
+    /**
+     * Runs sed for every spine pair as soon as the pairs it depends on are done. See dependents.
+     * 
+     * If a schedule of checkpoints is given, the tree edit distances between the nodes of both spines of every pair
+     * that is done are kept aside, and written whenever a checkpoint is due along with the pairs done. Since a pair
+     * is only done after the pairs it depends on, resuming from a checkpoint restores these distances to td and
+     * skips the pairs that were done. A pair that is cut short by the token is not done. Once the limit of the
+     * schedule is reached, a checkpoint is written and no other pair starts.
+     * 
+     * @param algorithm The name of the algorithm recorded in the checkpoints
+     * @param inputs The hash of the trees recorded in the checkpoints. See Checkpoint::hash
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param t1_spines The spines of T1
+     * @param t2_spines The spines of T2
+     * @param td Tree edit distances between nodes of T1 and T2
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     * @param token The token that tells when to stop. Pairs that start after it expires are skipped
+     * @param checkpoints The schedule of checkpoints, or nullptr. The checkpoint to resume from, if any, must have
+     * been written by the same algorithm for the same trees
+     * @param sed Computes the spine pair with the given index
+    */
+    void run_pairs(
+        const std::string& algorithm,
+        std::uint64_t inputs,
+        const Tree& t1,
+        const Tree& t2,
+        const std::vector<std::vector<int>>& t1_spines,
+        const std::vector<std::vector<int>>& t2_spines,
+        std::vector<std::vector<int>>& td,
+        int threads,
+        const CancelToken& token,
+        Checkpoints* checkpoints,
+        const std::function<void(int)>& sed
+    );
+
+    /**
+     * Finds the order in which spine pairs can be computed. Pair (a, b) stands for spines t1_spines[a] and
+     * t2_spines[b], and has index a * |t2_spines| + b.
      * 
-     * @returns An integer that represents the number of operations needed to transform t1 into t2.
-     * Each operation has unit cost.
+     * The SED of a pair only reads tree edit distances between nodes of its own spine in T1 and nodes below its
+     * spine in T2, and only writes those between nodes of both spines. Pairs with different spines in T1 are thus
+     * independent, and pair (a, b) only needs every pair (a, c) where c hangs from a node of b.
+     * 
+     * @param t2 An ordered labeled rooted tree
+     * @param t1_spines The spines of T1
+     * @param t2_spines The spines of T2
+     * 
+     * @returns For every spine pair, the pairs that depend on it
     */
-    int ted(const Tree& t1, const Tree& t2);
+    std::vector<std::vector<int>> dependents(
+        const Tree& t2,
+        const std::vector<std::vector<int>>& t1_spines,
+        const std::vector<std::vector<int>>& t2_spines
+    );
 
     /**
      * Computes the Spine Edit Distance (SED) between a spine S1 from T1 and a spine S2 from T2.
@@ -34,6 +106,7 @@ namespace SaeedScheme {
      * @param d2 A map to get the depth for any node in T2
      * @param td Tree edit distances needed to compute the edit distance for the two spines. This table will
      * be updated with new computed values of ted.
+     * @param token The token that tells when to stop. Once it expires, the remaining entries are left as they are
     */
     void sed(
         const Tree& t1, 
@@ -43,7 +116,8 @@ namespace SaeedScheme {
         const std::vector<int>& rl1,
         const std::vector<int>& rl2,
         const std::vector<int>& d2,
-        std::vector<std::vector<int>>& td
+        std::vector<std::vector<int>>& td,
+        const CancelToken& token = CancelToken()
     );
 }
 
@@ -1,24 +1,77 @@
 #include <saeedSchemeOpt.h>
 #include <zhangShasha.h>
+#include <saeedScheme.h>
+#include <parallel.h>
 #include <cmath>
 #include <limits>
 #include <cstdint>
 #include <algorithm>
 #include <assert.h>
 
+namespace {
+    /**
+     * Counts the cells of the rows or columns of the tables of every prefix shorter than k, where the prefix of
+     * length x has x + 1 of them.
+    */
+    long long cells(int k) {
+        return static_cast<long long>(k - 1) * (k + 2) / 2;
+    }
+}
+
 SaeedSchemeOpt::FEDDS::FEDDS(
     const Tree& f1,
     const Tree& f2,
-    const std::vector<std::vector<int>>& td
+    int threads
 ) : f1(f1), f2(f2) {
+    int n = f1.n;
+    int m = f2.n;
+
     std::vector<std::vector<int>> t = ZhangShasha::ted_complete(f1, f2);
 
-    for (int i = 1; i <= f1.n; ++i) {
-        for (int j = 1; j <= f2.n; ++j) {
-            std::vector<std::vector<int>> fedij = ZhangShasha::fed_complete(f1, 1, i, f2, 1, j, t);
-            feds.insert({ std::to_string(i) + std::to_string(j), fedij});
+    // A node whose subtree goes past the end of a prefix is an ancestor of its last node, so its rightmost leaf
+    // within the prefix is that last node
+    std::vector<int> rl1 = f1.rightmost();
+    std::vector<int> rl2 = f2.rightmost();
+
+    feds.resize(cells(n + 1) * cells(m + 1));
+
+    // Longer prefixes of F come first since their tables are larger
+    Parallel::for_each(n, [&](int x) {
+        int ir = n - x;
+
+        for (int jr = 1; jr <= m; ++jr) {
+            int w = jr + 1;
+            int* fd = feds.data() + offset(ir, jr);
+
+            auto at = [&](int i, int j) -> int& {
+                return fd[(i - 1) * w + j - 1];
+            };
+
+            at(ir + 1, jr + 1) = 0;
+            for (int i = ir; i >= 1; --i) {
+                // deletions
+                at(i, jr + 1) = at(i + 1, jr + 1) + 1;
+            }
+            for (int j = jr; j >= 1; --j) {
+                // insertions
+                at(ir + 1, j) = at(ir + 1, j + 1) + 1;
+            }
+
+            for (int i = ir; i >= 1; --i) {
+                int jump = std::min(rl1[i], ir) + 1;
+
+                for (int j = jr; j >= 1; --j) {
+                    at(i, j) = std::min(
+                        std::min(
+                            at(i + 1, j) + 1, // insert
+                            at(i, j + 1) + 1 // delete
+                        ),
+                        at(jump, std::min(rl2[j], jr) + 1) + t[i][j] // relabel
+                    );
+                }
+            }
         }
-    }
+    }, threads);
 }
 
 int SaeedSchemeOpt::FEDDS::query(
@@ -26,7 +79,7 @@ int SaeedSchemeOpt::FEDDS::query(
     int ir,
     int jl,
     int jr
-) {
+) const {
     if (il > ir && jl > jr) {
         return 0;
     }
@@ -39,13 +92,16 @@ int SaeedSchemeOpt::FEDDS::query(
         return ir - il + 1;
     }
 
-    std::string key = std::to_string(ir) + std::to_string(jr);
+    return feds[offset(ir, jr) + static_cast<long long>(il - 1) * (jr + 1) + jl - 1];
+}
 
-    return feds[key][il][jl];
+long long SaeedSchemeOpt::FEDDS::offset(int ir, int jr) const {
+    // Tables of shorter prefixes of F come first, and within them tables of shorter prefixes of F'
+    return cells(ir) * cells(f2.n + 1) + (ir + 1) * cells(jr);
 }
 
 
-int SaeedSchemeOpt::ted(const Tree& t1_or, const Tree& t2_or) {
+int SaeedSchemeOpt::ted(const Tree& t1_or, const Tree& t2_or, int threads, const CancelToken& token, Checkpoints* checkpoints) {
     // Let us first add a dummy root on top each tree by enclosing its preorder traversal in a zero-labeled node
     Tree t1("0(" + t1_or.pre_order() + ")");
     Tree t2("0(" + t2_or.pre_order() + ")");
@@ -75,13 +131,16 @@ int SaeedSchemeOpt::ted(const Tree& t1_or, const Tree& t2_or) {
     std::vector<int> t1_rightmost = t1.rightmost();
     std::vector<int> t2_rightmost = t2.rightmost();
 
-    for (auto const& s1: t1_spines) {
-        for (auto const& s2: t2_spines) {
-            SaeedSchemeOpt::sed(t1, t2, s1, s2, t1_rightmost, t2_rightmost, d1, d2, size_st1, td);
-        }
-    }
+    int spines = t2_spines.size();
 
-    return td[1][1];
+    SaeedScheme::run_pairs("SaeedOpt", Checkpoint::hash(t1_or, t2_or), t1, t2, t1_spines, t2_spines, td, threads, token, checkpoints, [&](int pair) {
+        const std::vector<int>& s1 = t1_spines[pair / spines];
+        const std::vector<int>& s2 = t2_spines[pair % spines];
+
+        SaeedSchemeOpt::sed(t1, t2, s1, s2, t1_rightmost, t2_rightmost, d1, d2, size_st1, td, Workspace::local(), token);
+    });
+
+    return token.cancelled() ? -1 : td[1][1];
 }
 
 void SaeedSchemeOpt::sed(
@@ -94,7 +153,9 @@ void SaeedSchemeOpt::sed(
     const std::vector<int>& d1,
     const std::vector<int>& d2,
     const std::vector<int>& size_st1,
-    std::vector<std::vector<int>>& td
+    std::vector<std::vector<int>>& td,
+    Workspace& ws,
+    const CancelToken& token
 ) {
     /**
      * Let us compute ted for two fixed nodes u and v in s1 and s2 respectively as follows.
@@ -149,25 +210,52 @@ void SaeedSchemeOpt::sed(
     // One of these structures represent the forest on the left hand side of the spine, and the other one
     // the forest on the right hand side.
     Tree f1_r = get_forest(s1[0] + 1, t1.n, s1, t1);
-    FEDDS fedds_r = FEDDS(f1_r, t2, td);
+    // Spine pairs already run in parallel, so the tables are filled on this thread alone
+    FEDDS fedds_r = FEDDS(f1_r, t2, 1);
 
     for (int i = 0; i < s1.size(); ++i) {
         for (int j = 0; j < s2.size(); ++j) {
+            if (token.expired()) {
+                return;
+            }
+
             int L = cost(s1[i], s2[j]);
 
             update_leaf(i, j);
 
+            if (i == 0) {
+                continue;
+            }
+
+            // The left forests of T2 only depend on l, so we build them once for every k
+            std::vector<Tree> f2_ls;
+            for (int l = s2[j] + 1; l < rl2[s2[j]] + 1; ++l) {
+                f2_ls.push_back(get_forest(s2[j], l - 1, t2.get_upwards_path(l, s2[j]) /* l does not necessarily belong in s2 */, t2));
+            }
+
             for (int k = 0; k < i; ++k) {
+                if (token.expired()) {
+                    return;
+                }
+
                 Tree f1_l = get_forest(s1[i], s1[k] - 1, s1, t1);
 
                 for (int l = s2[j] + 1; l < rl2[s2[j]] + 1; ++l) {
                     int R = (i - k - 1) + (d2[l] - d2[s2[j]] - 1);
 
-                    Tree f2_l = get_forest(s2[j], l - 1, t2.get_upwards_path(l, s2[j]) /* l does not necessarily belong in s2 */, t2);
+                    const Tree& f2_l = f2_ls[l - s2[j] - 1];
 
-                    int cl = ZhangShasha::fed(f1_l, 1, f1_l.n, f2_l, 1, f2_l.n, ZhangShasha::ted_complete(f1_l, f2_l));
+                    // Every table needed for this iteration comes from the workspace and is discarded at once
+                    Workspace::Mark mark = ws.mark();
+
+                    int cl = ZhangShasha::with_cell(f1_l.n + f2_l.n, [&](auto cell) {
+                        auto td = ZhangShasha::ted_complete<decltype(cell)>(f1_l, f2_l, ws);
+                        return ZhangShasha::fed(f1_l, 1, f1_l.n, f2_l, 1, f2_l.n, td, ws);
+                    });
                     int cr = fedds_r.query(rl1[s1[k]] - s1[0] + 1, rl1[s1[i]] - s1[0], rl2[l] + 1, rl2[s2[j]]);
 
+                    ws.release(mark);
+
                     int C = cl + cr;
 
                     td[s1[i]][s2[j]] = std::min(
@@ -2,12 +2,20 @@
 #define APPROXSCHEME_H
 
 #include <tree.h>
-#include <unordered_map>
+#include <cancelToken.h>
+#include <checkpoint.h>
+#include <workspace.h>
+#include <vector>
 
 namespace SaeedSchemeOpt {
     /**
      * A data structure that given two forests F1 and F2, computes the forest edit distance 
      * between any pair of subforests of F1 and F2
+     * 
+     * There is a table for every pair of prefixes F(1, ir) and F'(1, jr), which holds the distance between
+     * F(il, ir) and F'(jl, jr) for every il and jl. All of them live in a single array, and are filled in place
+     * from the same rightmost leaves, since the rightmost leaf of a node cut at ir is the smaller of its rightmost
+     * leaf and ir. Tables for different ir are filled in parallel.
     */
     struct FEDDS {
         // Forest F definition
@@ -17,13 +25,16 @@ namespace SaeedSchemeOpt {
         Tree f2;
 
         // collection of fed distances for subforests of F and F'
-        // key is of the form ij
-        std::unordered_map<std::string, std::vector<std::vector<int>>> feds;
+        // the table of F(1, ir) and F'(1, jr) starts at offset(ir, jr) and has a row of jr + 1 cells for every
+        // 1 <= il <= ir + 1, where cell jl - 1 holds the distance between F(il, ir) and F'(jl, jr)
+        std::vector<int> feds;
 
         /**
          * Constructs FEDDS given two subforests F and F'
+         * 
+         * @param threads The number of threads to use. If it is not positive, all hardware threads are used
         */
-        FEDDS(const Tree& f1, const Tree& f2, const std::vector<std::vector<int>>& td);
+        FEDDS(const Tree& f1, const Tree& f2, int threads = 0);
 
         /**
          * Answer queries of the form:
@@ -31,21 +42,38 @@ namespace SaeedSchemeOpt {
          * what is the FED between two subforests F(il, ir) and F'(jl, jr)?
          * 
         */
-        int query(int il, int ir, int jl, int jr);
+        int query(int il, int ir, int jl, int jr) const;
+
+        /**
+         * Gets the position in feds of the table of F(1, ir) and F'(1, jr).
+        */
+        long long offset(int ir, int jr) const;
     };
 
     /**
      * Computes the Tree Edit Distance (TED) between T1 and T2 using a variant of the approximation scheme algorithm 
      * described by Saeed Seddighin and others in 2019 in the paper 1+ϵ Approximation of Tree Edit
      * Distance in Quadratic Time. It is an optimization that seeks to reduce the number of duplicate computations
+     * 
+     * Spine pairs are scheduled on a pool of threads as soon as the pairs they depend on are done. See
+     * SaeedScheme::dependents.
 
      * @param t1 An ordered labeled rooted tree
      * @param t2 An ordered labeled rooted tree
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     * @param token The token that tells when to stop. It is checked before every pair of nodes of two spines
+     * @param checkpoints The schedule of checkpoints, if any. See SaeedScheme::run_pairs
      * 
-     * @returns An integer that represents the number of operations needed to transform t1 into t2.
-     * Each operation has unit cost.
+     * @returns An integer that represents the number of operations needed to transform t1 into t2, or -1 if the
+     * token expired first. Each operation has unit cost.
     */
-    int ted(const Tree& t1, const Tree& t2);
+    int ted(
+        const Tree& t1,
+        const Tree& t2,
+        int threads = 0,
+        const CancelToken& token = CancelToken(),
+        Checkpoints* checkpoints = nullptr
+    );
 
     /**
      * Computes the Spine Edit Distance (SED) between a spine S1 from T1 and a spine S2 from T2.
@@ -63,6 +91,8 @@ namespace SaeedSchemeOpt {
      * @param d2 A map to get the depth for any node in T2
      * @param size_st1 A map to get the size of any subtree of T1
      * @param td Tree edit distances needed to compute the edit distance for the two spines
+     * @param ws The workspace that provides the scratch tables for every iteration
+     * @param token The token that tells when to stop. Once it expires, the remaining entries are left as they are
     */
     void sed(
         const Tree& t1, 
@@ -74,7 +104,9 @@ namespace SaeedSchemeOpt {
         const std::vector<int>& d1,
         const std::vector<int>& d2,
         const std::vector<int>& size_st1,
-        std::vector<std::vector<int>>& td
+        std::vector<std::vector<int>>& td,
+        Workspace& ws,
+        const CancelToken& token = CancelToken()
     );
 }
 
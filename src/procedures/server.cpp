@@ -0,0 +1,394 @@
+#include <server.h>
+#include <protocol.h>
+#include <parallel.h>
+#include <zhangShasha.h>
+#include <constrained.h>
+#include <workspace.h>
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <sstream>
+#include <queue>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std::chrono;
+
+// Commands understood by the server
+static const char* COMMANDS[] = {"ADD", "REMOVE", "DIST", "THRESH", "KNN", "STATS"};
+
+namespace {
+    /**
+     * Reads a whole argument as an integer without throwing. Returns whether it is one.
+    */
+    bool parse(const std::string& arg, int& value) {
+        auto r = std::from_chars(arg.data(), arg.data() + arg.size(), value);
+
+        return r.ec == std::errc() && r.ptr == arg.data() + arg.size();
+    }
+}
+
+Server::Server(int threads) : threads(threads > 0 ? threads : Parallel::threads()) {
+    for (const char* command: COMMANDS) {
+        latencies[command];
+    }
+}
+
+void Server::add(const std::string& name, const Tree& t) {
+    auto entry = std::make_shared<Entry>();
+    entry->prepared = PreparedTree(t);
+    entry->signature = Bounds::signature(t);
+
+    std::unique_lock<std::shared_mutex> lock(corpus_mutex);
+    corpus[name] = entry;
+}
+
+std::shared_ptr<const Server::Entry> Server::resolve(const std::string& tree, std::string& error) const {
+    if (tree.find('(') != std::string::npos) {
+        if (!Tree::valid(tree)) {
+            error = "ERR invalid tree " + tree;
+            return nullptr;
+        }
+
+        auto entry = std::make_shared<Entry>();
+        Tree t(tree);
+
+        entry->prepared = PreparedTree(t);
+        entry->signature = Bounds::signature(t);
+
+        return entry;
+    }
+
+    std::shared_lock<std::shared_mutex> lock(corpus_mutex);
+    auto it = corpus.find(tree);
+
+    if (it == corpus.end()) {
+        error = "ERR unknown tree " + tree;
+        return nullptr;
+    }
+
+    return it->second;
+}
+
+std::string Server::handle(const std::string& request) {
+    std::istringstream in(request);
+    std::vector<std::string> args;
+
+    std::string arg;
+    while (in >> arg) {
+        args.push_back(arg);
+    }
+
+    if (args.empty()) {
+        return "ERR empty request";
+    }
+
+    auto start = high_resolution_clock::now();
+
+    std::string response;
+
+    // A request must never take the server down, whatever went wrong while answering it
+    try {
+        response = dispatch(args);
+    } catch (const std::bad_alloc&) {
+        response = "ERR out of memory";
+    } catch (const std::exception& e) {
+        response = std::string("ERR ") + e.what();
+    }
+
+    auto stop = high_resolution_clock::now();
+
+    auto it = latencies.find(args[0]);
+    if (it != latencies.end()) {
+        long long us = duration_cast<microseconds>(stop - start).count();
+
+        int bucket = 0;
+        while (bucket < 31 && (1LL << bucket) <= us) {
+            ++bucket;
+        }
+
+        ++it->second.buckets[bucket];
+        ++it->second.count;
+    }
+
+    return response;
+}
+
+std::string Server::dispatch(const std::vector<std::string>& args) {
+    const std::string& command = args[0];
+
+    if (command == "ADD" && args.size() == 3) {
+        if (!Tree::valid(args[2])) {
+            return "ERR invalid tree " + args[2];
+        }
+
+        add(args[1], Tree(args[2]));
+        return "OK";
+    }
+
+    if (command == "REMOVE" && args.size() == 2) {
+        std::unique_lock<std::shared_mutex> lock(corpus_mutex);
+        return corpus.erase(args[1]) > 0 ? "OK" : "ERR unknown tree " + args[1];
+    }
+
+    if ((command == "DIST" && args.size() == 3) || (command == "THRESH" && args.size() == 4)) {
+        int tau = 0;
+
+        if (command == "THRESH" && !parse(args[3], tau)) {
+            return "ERR invalid threshold " + args[3];
+        }
+
+        std::string error;
+        auto t1 = resolve(args[1], error);
+        auto t2 = t1 ? resolve(args[2], error) : nullptr;
+
+        if (!t1 || !t2) {
+            return error;
+        }
+
+        if (command == "THRESH" && Bounds::lower_bound(t1->signature, t2->signature) > tau) {
+            return "OK NO";
+        }
+
+        // The constrained distance is an upper bound, so it can accept the pair without the exact distance
+        if (command == "THRESH" && Constrained::ted(t1->prepared.tree, t2->prepared.tree) <= tau) {
+            return "OK YES";
+        }
+
+        int d = ZhangShasha::ted(t1->prepared, t2->prepared, Workspace::local());
+
+        if (command == "DIST") {
+            return "OK " + std::to_string(d);
+        }
+
+        return d <= tau ? "OK YES" : "OK NO";
+    }
+
+    if (command == "KNN" && args.size() == 3) {
+        int k = 0;
+
+        if (!parse(args[2], k)) {
+            return "ERR invalid count " + args[2];
+        }
+
+        std::string error;
+        auto q = resolve(args[1], error);
+
+        if (!q) {
+            return error;
+        }
+
+        std::vector<std::pair<std::string, std::shared_ptr<const Entry>>> entries;
+        {
+            std::shared_lock<std::shared_mutex> lock(corpus_mutex);
+            entries.assign(corpus.begin(), corpus.end());
+        }
+
+        // Visit the corpus by increasing lower bound so that we can stop as soon as no tree left can beat
+        // the k-th best distance found so far
+        std::vector<std::pair<int, int>> order;
+        for (int i = 0; i < entries.size(); ++i) {
+            order.push_back({Bounds::lower_bound(q->signature, entries[i].second->signature), i});
+        }
+
+        std::sort(order.begin(), order.end());
+
+        std::priority_queue<std::pair<int, int>> best;
+        int evaluations = 0;
+
+        for (const auto& o: order) {
+            if (k <= 0 || (best.size() == k && o.first >= best.top().first)) {
+                break;
+            }
+
+            int d = ZhangShasha::ted(q->prepared, entries[o.second].second->prepared, Workspace::local());
+            ++evaluations;
+
+            best.push({d, o.second});
+            if (best.size() > k) {
+                best.pop();
+            }
+        }
+
+        std::vector<std::pair<int, int>> result;
+        while (!best.empty()) {
+            result.push_back(best.top());
+            best.pop();
+        }
+
+        std::sort(result.begin(), result.end());
+
+        std::string response = "OK " + std::to_string(evaluations);
+        for (const auto& r: result) {
+            response += " " + entries[r.second].first + ":" + std::to_string(r.first);
+        }
+
+        return response;
+    }
+
+    if (command == "STATS" && args.size() == 1) {
+        return stats();
+    }
+
+    return "ERR invalid request";
+}
+
+std::string Server::stats() const {
+    std::string response = "OK";
+
+    for (const auto& entry: latencies) {
+        const Histogram& h = entry.second;
+        long long count = h.count;
+
+        response += "\n" + entry.first + " count=" + std::to_string(count);
+
+        // Upper bound of the bucket that holds the given percentile
+        auto percentile = [&](double p) {
+            long long seen = 0;
+
+            for (int b = 0; b < h.buckets.size(); ++b) {
+                seen += h.buckets[b];
+
+                if (seen > 0 && seen >= p * count) {
+                    return 1LL << b;
+                }
+            }
+
+            return 0LL;
+        };
+
+        if (count > 0) {
+            response += " p50<" + std::to_string(percentile(0.5)) + "us";
+            response += " p90<" + std::to_string(percentile(0.9)) + "us";
+            response += " p99<" + std::to_string(percentile(0.99)) + "us";
+        }
+
+        response += " buckets=";
+        for (int b = 0; b < h.buckets.size(); ++b) {
+            response += (b > 0 ? "," : "") + std::to_string(h.buckets[b]);
+        }
+    }
+
+    return response;
+}
+
+int Server::serve(int in, int out) {
+    Parallel::Pool pool(threads);
+
+    serve(in, out, pool);
+
+    return 0;
+}
+
+void Server::serve(int in, int out, Parallel::Pool& pool) {
+    // Responses that are ready but wait for the ones of earlier requests
+    std::map<long long, std::string> ready;
+    long long next = 0;
+    std::mutex mutex;
+
+    // Requests of this stream that were read but not answered yet. The pool may be shared with other streams,
+    // so it cannot be waited on.
+    long long pending = 0;
+    std::condition_variable answered;
+
+    // Answers a request and writes every response that is no longer waiting for an earlier one
+    auto answer = [this, out, &ready, &next, &mutex, &pending, &answered](long long id, const std::string& request) {
+        std::string response = handle(request);
+
+        std::lock_guard<std::mutex> lock(mutex);
+        ready[id] = response;
+
+        while (!ready.empty() && ready.begin()->first == next) {
+            Protocol::write_frame(out, ready.begin()->second);
+            ready.erase(ready.begin());
+            ++next;
+        }
+
+        if (--pending == 0) {
+            answered.notify_all();
+        }
+    };
+
+    std::string request;
+    for (long long id = 0; Protocol::read_frame(in, request); ++id) {
+        std::string command;
+        std::istringstream(request) >> command;
+
+        // Requests that change the corpus are a barrier for the stream. They wait for every earlier request and
+        // are answered before any later one is read, so that a pipelined ADD x is seen by the DIST x after it.
+        // STATS is one too, so that it counts every request before it.
+        bool barrier = command == "ADD" || command == "REMOVE" || command == "STATS";
+
+        std::unique_lock<std::mutex> lock(mutex);
+
+        if (barrier) {
+            answered.wait(lock, [&]() { return pending == 0; });
+        }
+
+        ++pending;
+        lock.unlock();
+
+        if (barrier) {
+            answer(id, request);
+        } else {
+            pool.submit([answer, id, request]() {
+                answer(id, request);
+            });
+        }
+    }
+
+    std::unique_lock<std::mutex> lock(mutex);
+    answered.wait(lock, [&]() { return pending == 0; });
+}
+
+int Server::listen(const std::string& path) {
+#ifdef _WIN32
+    return 1;
+#else
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    if (fd < 0) {
+        return 1;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+
+    if (path.size() >= sizeof(address.sun_path)) {
+        close(fd);
+        return 1;
+    }
+
+    std::copy(path.begin(), path.end(), address.sun_path);
+    unlink(path.c_str());
+
+    if (bind(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 || ::listen(fd, 128) < 0) {
+        close(fd);
+        return 1;
+    }
+
+    Parallel::Pool pool(threads);
+
+    while (true) {
+        int connection = accept(fd, nullptr, nullptr);
+
+        if (connection < 0) {
+            continue;
+        }
+
+        // Every connection waits for its requests on its own thread, so that idle connections do not hold the
+        // workers of the pool, which only answer requests
+        std::thread([this, connection, &pool]() {
+            serve(connection, connection, pool);
+            close(connection);
+        }).detach();
+    }
+#endif
+}
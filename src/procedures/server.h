@@ -0,0 +1,111 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+#include <tree.h>
+#include <preparedTree.h>
+#include <bounds.h>
+#include <parallel.h>
+#include <array>
+#include <atomic>
+#include <map>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <vector>
+
+/**
+ * A long lived process that keeps a corpus of trees resident along with their structural arrays, and answers
+ * tree edit distance requests on a pool of worker threads.
+ * 
+ * Requests and responses are text messages sent in frames as described by the Protocol namespace. A request is
+ * a command followed by its arguments separated by spaces. Trees may be given by the name they were registered
+ * with, or inline as a pre-order traversal.
+ * 
+ *      ADD <name> <tree>           Registers a tree under a name, replacing any previous one
+ *      REMOVE <name>               Unregisters a tree
+ *      DIST <tree> <tree>          Computes the tree edit distance
+ *      THRESH <tree> <tree> <tau>  Tells whether the distance is at most tau
+ *      KNN <tree> <k>              Finds the k registered trees closest to the given one
+ *      STATS                       Reports latency histograms for every command
+ * 
+ * Responses start with OK followed by the result, or with ERR followed by a description of the problem. Malformed
+ * requests, such as trees that are not valid pre-order traversals or numbers that cannot be read, get an ERR
+ * response and never stop the server.
+ * 
+ * THRESH answers OK YES without the distance, since a pair within tau by the constrained distance is accepted
+ * before the exact one is computed. Earlier versions answered OK YES followed by the distance, so clients that
+ * read it must send DIST instead.
+*/
+struct Server {
+    /**
+     * A registered tree along with everything derived from it.
+    */
+    struct Entry {
+        PreparedTree prepared;
+        Bounds::Signature signature;
+    };
+
+    /**
+     * Latencies of a command, in buckets where bucket b counts requests that took less than 2^b microseconds.
+    */
+    struct Histogram {
+        std::array<std::atomic<long long>, 32> buckets{};
+        std::atomic<long long> count{0};
+    };
+
+    /**
+     * Constructs a server with an empty corpus.
+     * 
+     * @param threads The number of worker threads. If it is not positive, all hardware threads are used
+    */
+    Server(int threads = 0);
+
+    /**
+     * Registers a tree under the given name, replacing any previous one.
+    */
+    void add(const std::string& name, const Tree& t);
+
+    /**
+     * Answers a single request. It is safe to call it concurrently.
+     * 
+     * @param request The text of the request
+     * 
+     * @returns The text of the response
+    */
+    std::string handle(const std::string& request);
+
+    /**
+     * Serves the requests read from one file descriptor and writes the responses to another, until the input
+     * ends. Requests are answered concurrently, but responses are written in the order of the requests.
+     * ADD, REMOVE and STATS wait for every earlier request of the stream and finish before any later one starts.
+     * 
+     * @returns Zero once the input ends
+    */
+    int serve(int in, int out);
+
+    /**
+     * Listens on a Unix domain socket and serves every connection until the process is stopped. Every connection
+     * is read on its own thread, while requests from all of them are answered by a shared pool of workers, and
+     * the responses of a connection are written in the order of its requests.
+     * 
+     * @param path The path of the socket
+     * 
+     * @returns A non zero value if the socket could not be opened
+    */
+    int listen(const std::string& path);
+
+private:
+    int threads;
+
+    std::map<std::string, std::shared_ptr<const Entry>> corpus;
+    mutable std::shared_mutex corpus_mutex;
+
+    std::map<std::string, Histogram> latencies;
+
+    std::string dispatch(const std::vector<std::string>& args);
+    std::shared_ptr<const Entry> resolve(const std::string& tree, std::string& error) const;
+    void serve(int in, int out, Parallel::Pool& pool);
+    std::string stats() const;
+};
+
+#endif
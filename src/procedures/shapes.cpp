@@ -0,0 +1,269 @@
+#include <shapes.h>
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+
+namespace {
+    typedef std::uint64_t Word;
+
+    // Number of bits in a word
+    const int W = 64;
+
+    /**
+     * The bit-parallel encoding of a pattern. For every distinct label, a bit vector marks the positions of the
+     * pattern where it occurs.
+    */
+    struct Pattern {
+        int length;
+        int blocks;
+
+        // Maps a label to its row in peq. Labels that do not occur in the pattern use the last row, which is empty.
+        std::unordered_map<int, int> ids;
+        std::vector<Word> peq;
+
+        Pattern(const std::vector<int>& labels) {
+            length = labels.size();
+            blocks = (length + W - 1) / W;
+
+            for (int label: labels) {
+                ids.insert({label, static_cast<int>(ids.size())});
+            }
+
+            peq.assign((ids.size() + 1) * blocks, 0);
+
+            for (int i = 0; i < length; ++i) {
+                peq[ids[labels[i]] * blocks + i / W] |= Word(1) << (i % W);
+            }
+        }
+
+        /**
+         * Gets the bit vector of a label.
+        */
+        const Word* eq(int label) const {
+            auto it = ids.find(label);
+            return peq.data() + (it == ids.end() ? ids.size() : it->second) * blocks;
+        }
+    };
+
+    /**
+     * A column of the edit distance table encoded as its vertical differences, along with the value of its last cell.
+    */
+    struct Column {
+        std::vector<Word> pv;
+        std::vector<Word> mv;
+        int score;
+    };
+
+    /**
+     * Gets the first column of the table, where the value of row i is i.
+    */
+    Column start(const Pattern& p) {
+        return Column{std::vector<Word>(p.blocks, ~Word(0)), std::vector<Word>(p.blocks, 0), p.length};
+    }
+
+    /**
+     * Moves a column one symbol of the text forward.
+     *
+     * Each block gets the horizontal difference of the row above it from the block before, which is +1 for the
+     * first block since the value of the first row grows by one with every symbol.
+    */
+    void advance(const Pattern& p, Column& c, const Word* eq) {
+        int hin = 1;
+
+        for (int b = 0; b < p.blocks; ++b) {
+            Word pv = c.pv[b];
+            Word mv = c.mv[b];
+            Word e = eq[b];
+
+            Word negative = hin < 0 ? 1 : 0;
+
+            Word xv = e | mv;
+            e |= negative;
+            Word xh = (((e & pv) + pv) ^ pv) | e;
+            Word ph = mv | ~(xh | pv);
+            Word mh = pv & xh;
+
+            // Bits past the end of the pattern never affect the ones before it, so the last block stops there
+            int high = b + 1 < p.blocks ? W - 1 : (p.length - 1) % W;
+            int hout = static_cast<int>((ph >> high) & 1) - static_cast<int>((mh >> high) & 1);
+
+            ph = (ph << 1) | (hin > 0 ? 1 : 0);
+            mh = (mh << 1) | negative;
+
+            c.pv[b] = mh | ~(xv | ph);
+            c.mv[b] = ph & xv;
+
+            hin = hout;
+        }
+
+        c.score += hin;
+    }
+}
+
+bool Shapes::is_path(const Tree& t) {
+    for (int u = 1; u <= t.n; ++u) {
+        if (t.adj[u].size() > 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+bool Shapes::is_star(const Tree& t) {
+    for (int u = 2; u <= t.n; ++u) {
+        if (t.parent[u] != 1) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+int Shapes::sed(const std::vector<int>& a, const std::vector<int>& b) {
+    if (a.size() > b.size()) {
+        return sed(b, a);
+    }
+
+    Pattern p(a);
+    Column c = start(p);
+
+    for (int label: b) {
+        advance(p, c, p.eq(label));
+    }
+
+    return c.score;
+}
+
+int Shapes::path_ted(const Tree& p, const Tree& t) {
+    if (p.n == 0 || t.n == 0) {
+        return p.n + t.n;
+    }
+
+    Pattern pattern(std::vector<int>(p.labels.begin() + 1, p.labels.end()));
+
+    std::vector<int> size = t.size_subtrees();
+
+    // The child with the largest subtree continues with the column of its parent. Every other child starts from
+    // a copy of it, so a copy is only alive while a light child is being visited.
+    std::vector<int> heavy(t.n + 1, 0);
+    for (int u = 1; u <= t.n; ++u) {
+        for (int v: t.adj[u]) {
+            if (heavy[u] == 0 || size[v] > size[heavy[u]]) {
+                heavy[u] = v;
+            }
+        }
+    }
+
+    // A node whose light children are being visited, with the column up to and including it
+    struct Frame {
+        int u;
+        int next;
+        int depth;
+        Column column;
+    };
+
+    std::vector<Frame> frames;
+
+    int u = 1;
+    int depth = 1;
+    Column c = start(pattern);
+    advance(pattern, c, pattern.eq(t.labels[u]));
+
+    int best = p.n + t.n;
+
+    while (true) {
+        if (t.adj[u].empty()) {
+            best = std::min(best, c.score + t.n - depth);
+        } else if (t.adj[u].size() == 1) {
+            u = heavy[u];
+            ++depth;
+            advance(pattern, c, pattern.eq(t.labels[u]));
+            continue;
+        } else {
+            frames.push_back(Frame{u, 0, depth, std::move(c)});
+        }
+
+        // Move on to the next light child of the deepest pending node, or to its heavy child once they are done
+        if (frames.empty()) {
+            break;
+        }
+
+        Frame& f = frames.back();
+        const std::vector<int>& children = t.adj[f.u];
+
+        while (f.next < children.size() && children[f.next] == heavy[f.u]) {
+            ++f.next;
+        }
+
+        depth = f.depth + 1;
+
+        if (f.next < children.size()) {
+            u = children[f.next++];
+            c = f.column;
+        } else {
+            u = heavy[f.u];
+            c = std::move(f.column);
+            frames.pop_back();
+        }
+
+        advance(pattern, c, pattern.eq(t.labels[u]));
+    }
+
+    return best;
+}
+
+int Shapes::star_ted(const Tree& s1, const Tree& s2) {
+    int n = s1.n;
+    int m = s2.n;
+
+    if (n == 0 || m == 0) {
+        return n + m;
+    }
+
+    auto cost = [](int a, int b) {
+        return a == b ? 0 : 1;
+    };
+
+    // Both roots are mapped and the leaves are aligned
+    std::vector<int> l1(s1.labels.begin() + 2, s1.labels.end());
+    std::vector<int> l2(s2.labels.begin() + 2, s2.labels.end());
+
+    int best = cost(s1.labels[1], s2.labels[1]) + sed(l1, l2);
+
+    // A root is mapped to a leaf of the other tree, which rules out every other pair
+    for (int y = 2; y <= m; ++y) {
+        best = std::min(best, n + m - 2 + cost(s1.labels[1], s2.labels[y]));
+    }
+
+    for (int x = 2; x <= n; ++x) {
+        best = std::min(best, n + m - 2 + cost(s1.labels[x], s2.labels[1]));
+    }
+
+    return best;
+}
+
+bool Shapes::ted(const Tree& t1, const Tree& t2, int& d) {
+    if (is_path(t1) && is_path(t2)) {
+        d = sed(std::vector<int>(t1.labels.begin() + std::min<int>(1, t1.labels.size()), t1.labels.end()),
+                std::vector<int>(t2.labels.begin() + std::min<int>(1, t2.labels.size()), t2.labels.end()));
+        return true;
+    }
+
+    if (is_path(t1)) {
+        d = path_ted(t1, t2);
+        return true;
+    }
+
+    if (is_path(t2)) {
+        d = path_ted(t2, t1);
+        return true;
+    }
+
+    if (is_star(t1) && is_star(t2)) {
+        d = star_ted(t1, t2);
+        return true;
+    }
+
+    return false;
+}
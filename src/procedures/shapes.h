@@ -0,0 +1,81 @@
+#ifndef SHAPES_H
+#define SHAPES_H
+
+#include <tree.h>
+#include <vector>
+
+/**
+ * Exact Tree Edit Distance (TED) for trees with special shapes, where the problem reduces to string edit distance.
+ *
+ * Every routine here gives the same distance as ZhangShasha with unit costs.
+*/
+namespace Shapes {
+    /**
+     * Tells whether every node of T has at most one child.
+    */
+    bool is_path(const Tree& t);
+
+    /**
+     * Tells whether every child of the root of T is a leaf.
+    */
+    bool is_star(const Tree& t);
+
+    /**
+     * Computes the unit cost string edit distance between two sequences of labels with the bit-parallel algorithm
+     * described by Myers in 1999 and extended to several machine words by Hyyro in 2003.
+     *
+     * It requires O(ceil(a / w) * b) time where a is the length of the shorter sequence, b is the length of the
+     * longer one and w is the number of bits in a machine word.
+     *
+     * @param a A sequence of labels
+     * @param b A sequence of labels
+     *
+     * @returns The minimum number of insertions, deletions and substitutions that transform a into b
+    */
+    int sed(const std::vector<int>& a, const std::vector<int>& b);
+
+    /**
+     * Computes the TED between a path P and any tree T.
+     *
+     * The nodes of T that are mapped to P must lie on a single path from the root, so the distance is the minimum
+     * over every leaf of the string edit distance between P and the path from the root to that leaf, plus the
+     * number of nodes of T off that path. Paths of T share the bit-parallel state of their common prefix. Light
+     * children are visited first so that only O(lgm) states are alive at any time.
+     *
+     * It requires O(ceil(n / w) * m) time where n and m are the number of nodes in P and T.
+     *
+     * @param p A tree where every node has at most one child
+     * @param t An ordered labeled rooted tree
+     *
+     * @returns The tree edit distance between P and T
+    */
+    int path_ted(const Tree& p, const Tree& t);
+
+    /**
+     * Computes the TED between two trees whose nodes are all children of the root.
+     *
+     * Either both roots are mapped to each other and the leaves are aligned as strings, or at most one pair of
+     * nodes is mapped because a root mapped to a leaf leaves nothing else to map.
+     *
+     * It requires O(ceil(n / w) * m) time where n and m are the number of nodes in S1 and S2.
+     *
+     * @param s1 A tree where every child of the root is a leaf
+     * @param s2 A tree where every child of the root is a leaf
+     *
+     * @returns The tree edit distance between S1 and S2
+    */
+    int star_ted(const Tree& s1, const Tree& s2);
+
+    /**
+     * Computes the TED between T1 and T2 with one of the specialized routines if their shapes allow it.
+     *
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param d The distance between T1 and T2 if a specialized routine applies
+     *
+     * @returns True if a specialized routine applies to T1 and T2
+    */
+    bool ted(const Tree& t1, const Tree& t2, int& d);
+}
+
+#endif
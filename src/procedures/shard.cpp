@@ -0,0 +1,65 @@
+#include <shard.h>
+#include <algorithm>
+#include <queue>
+#include <sstream>
+
+bool Shard::parse(const std::string& text, Spec& spec) {
+    std::istringstream in(text);
+    char slash = 0;
+
+    if (!(in >> spec.index >> slash >> spec.count) || slash != '/' || !in.eof()) {
+        return false;
+    }
+
+    return spec.count > 0 && spec.index >= 0 && spec.index < spec.count;
+}
+
+long long Shard::cost(const Tree& t) {
+    std::vector<int> size = t.size_subtrees();
+
+    // A node is a keyroot if it is the root or if it is not the last child of its parent
+    long long total = 0;
+    for (int u = 1; u <= t.n; ++u) {
+        int p = t.parent[u];
+
+        if (p == 0 || t.adj[p].back() != u) {
+            total += size[u];
+        }
+    }
+
+    return total;
+}
+
+std::vector<int> Shard::rows(const std::vector<long long>& costs, const Spec& spec) {
+    std::vector<int> order(costs.size());
+    for (int i = 0; i < costs.size(); ++i) {
+        order[i] = i;
+    }
+
+    std::stable_sort(order.begin(), order.end(), [&](int x, int y) {
+        return costs[x] > costs[y];
+    });
+
+    // Shards ordered by their cost so far and then by index
+    std::priority_queue<std::pair<long long, int>, std::vector<std::pair<long long, int>>, std::greater<>> load;
+    for (int s = 0; s < spec.count; ++s) {
+        load.push({0, s});
+    }
+
+    std::vector<int> result;
+
+    for (int row: order) {
+        auto [total, s] = load.top();
+        load.pop();
+
+        if (s == spec.index) {
+            result.push_back(row);
+        }
+
+        load.push({total + costs[row], s});
+    }
+
+    std::sort(result.begin(), result.end());
+
+    return result;
+}
@@ -0,0 +1,62 @@
+#ifndef SHARD_H
+#define SHARD_H
+
+#include <tree.h>
+#include <string>
+#include <vector>
+
+/**
+ * Splits the rows of a pair space, such as A x B in a join or the upper triangle of an all-pairs matrix, among
+ * N independent processes.
+ *
+ * The partition only depends on the trees and on N, so every process computes the same assignment without
+ * talking to the others, and a failed shard can be run again on its own.
+*/
+namespace Shard {
+    /**
+     * Identifies a shard as the i-th out of N, with 0 <= i < N.
+    */
+    struct Spec {
+        int index = 0;
+        int count = 1;
+    };
+
+    /**
+     * Parses a shard given as "i/N".
+     *
+     * @param text The shard specification
+     * @param spec The shard that will be filled in
+     *
+     * @returns True if the specification is well formed and 0 <= i < N
+    */
+    bool parse(const std::string& text, Spec& spec);
+
+    /**
+     * Estimates the work that ZhangShasha does for T as a factor of the work for a pair.
+     *
+     * ZhangShasha fills a table of size |T1(k)| x |T2(l)| for every pair of keyroots k and l, so the work for
+     * the pair is cost(T1) * cost(T2), where cost(T) is the sum of the sizes of the subtrees rooted at its keyroots.
+     *
+     * It requires O(n) time.
+     *
+     * @param t An ordered labeled rooted tree
+     *
+     * @returns The sum of the sizes of the subtrees rooted at the keyroots of T
+    */
+    long long cost(const Tree& t);
+
+    /**
+     * Assigns rows to shards so that the total cost of each shard is balanced.
+     *
+     * Rows are taken by decreasing cost and each one goes to the shard with the least cost so far. Ties are
+     * broken by position, so the assignment is deterministic.
+     *
+     * @param costs The cost of every row
+     * @param spec The shard whose rows are wanted
+     *
+     * @returns The rows assigned to the given shard in increasing order
+    */
+    std::vector<int> rows(const std::vector<long long>& costs, const Spec& spec);
+}
+
+#endif
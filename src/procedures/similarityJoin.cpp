@@ -0,0 +1,96 @@
+#include <similarityJoin.h>
+#include <bounds.h>
+#include <zhangShasha.h>
+#include <constrained.h>
+#include <parallel.h>
+#include <algorithm>
+#include <atomic>
+
+std::vector<std::pair<int, int>> SimilarityJoin::join(
+    const Corpus& a,
+    const Corpus& b,
+    int tau,
+    Stats& stats,
+    int threads
+) {
+    // Signatures of A are only needed while their tree is joined, but every tree of B is a candidate many times
+    std::vector<Bounds::Signature> sb(b.size());
+
+    Parallel::for_each(b.size(), [&](int i) { sb[i] = Bounds::signature(b.tree(i)); }, threads);
+
+    // Index B by size so the candidates for a tree of size n are a contiguous range
+    std::vector<int> by_size(b.size());
+    for (int i = 0; i < b.size(); ++i) {
+        by_size[i] = i;
+    }
+
+    std::stable_sort(by_size.begin(), by_size.end(), [&](int x, int y) {
+        return b.nodes(x) < b.nodes(y);
+    });
+
+    std::atomic<long long> candidates(0), pruned(0), accepted(0), verified(0);
+
+    std::vector<std::vector<int>> matches(a.size());
+
+    Parallel::for_each(a.size(), [&](int i) {
+        Tree t1 = a.tree(i);
+        Bounds::Signature s1 = Bounds::signature(t1);
+
+        auto first = std::lower_bound(by_size.begin(), by_size.end(), t1.n - tau, [&](int x, int n) {
+            return b.nodes(x) < n;
+        });
+        auto last = std::upper_bound(by_size.begin(), by_size.end(), t1.n + tau, [&](int n, int x) {
+            return n < b.nodes(x);
+        });
+
+        long long c = 0, p = 0, u = 0, v = 0;
+
+        for (auto it = first; it != last; ++it) {
+            int j = *it;
+            ++c;
+
+            if (Bounds::lower_bound(s1, sb[j]) > tau) {
+                ++p;
+                continue;
+            }
+
+            Tree t2 = b.tree(j);
+
+            if (Constrained::ted(t1, t2) <= tau) {
+                ++u;
+                matches[i].push_back(j);
+                continue;
+            }
+
+            ++v;
+
+            if (ZhangShasha::ted(t1, t2) <= tau) {
+                matches[i].push_back(j);
+            }
+        }
+
+        std::sort(matches[i].begin(), matches[i].end());
+
+        candidates += c;
+        pruned += p;
+        accepted += u;
+        verified += v;
+    }, threads);
+
+    std::vector<std::pair<int, int>> result;
+
+    for (int i = 0; i < a.size(); ++i) {
+        for (int j: matches[i]) {
+            result.push_back({i, j});
+        }
+    }
+
+    stats.pairs += static_cast<long long>(a.size()) * b.size();
+    stats.candidates += candidates;
+    stats.pruned += pruned;
+    stats.accepted += accepted;
+    stats.verified += verified;
+    stats.matches += result.size();
+
+    return result;
+}
@@ -0,0 +1,54 @@
+#ifndef SIMILARITYJOIN_H
+#define SIMILARITYJOIN_H
+
+#include <corpus.h>
+#include <vector>
+#include <utility>
+
+namespace SimilarityJoin {
+    /**
+     * Counters that describe how much work the filters saved during a join.
+    */
+    struct Stats {
+        // Number of pairs in A x B.
+        long long pairs = 0;
+        // Number of pairs whose sizes are close enough to be within the threshold.
+        long long candidates = 0;
+        // Number of candidates discarded by the label histogram lower bound.
+        long long pruned = 0;
+        // Number of candidates accepted because their constrained distance is within the threshold.
+        long long accepted = 0;
+        // Number of candidates whose exact distance was computed.
+        long long verified = 0;
+        // Number of pairs within the threshold.
+        long long matches = 0;
+    };
+
+    /**
+     * Finds every pair (a, b) from collections A and B such that the Tree Edit Distance (TED) between
+     * a and b is at most tau.
+     * 
+     * Collection B is indexed by size, so only trees whose size differs by at most tau from a are considered
+     * candidates for a. Candidates are then filtered with the label histogram lower bound. Pairs whose constrained
+     * edit distance, which is an upper bound, is within the threshold are accepted right away, and the remaining
+     * pairs are verified with ZhangShasha. Trees in A are processed in parallel, and trees are only expanded from
+     * their compact form while they are compared.
+     * 
+     * @param a A corpus of ordered labeled rooted trees
+     * @param b A corpus of ordered labeled rooted trees
+     * @param tau The largest distance allowed between a pair
+     * @param stats Counters that will be updated with the work done by the join
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+     * 
+     * @returns The indices of every pair within the threshold sorted by index in A and then by index in B.
+    */
+    std::vector<std::pair<int, int>> join(
+        const Corpus& a,
+        const Corpus& b,
+        int tau,
+        Stats& stats,
+        int threads = 0
+    );
+}
+
+#endif
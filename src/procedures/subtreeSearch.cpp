@@ -0,0 +1,77 @@
+#include <subtreeSearch.h>
+#include <zhangShasha.h>
+#include <workspace.h>
+#include <algorithm>
+#include <set>
+#include <unordered_set>
+
+std::vector<SubtreeSearch::Match> SubtreeSearch::search(
+    const Tree& query,
+    const Tree& document,
+    int k,
+    int tau,
+    const std::function<void(const Match& match, bool added)>& on_update
+) {
+    auto worse = [](const Match& a, const Match& b) {
+        return a.distance < b.distance || (a.distance == b.distance && a.node < b.node);
+    };
+
+    // best matches so far, where the last one is the worst
+    std::set<Match, decltype(worse)> best(worse);
+
+    auto bound = [&]() {
+        return k > 0 && best.size() == k ? std::min(tau, std::prev(best.end())->distance) : tau;
+    };
+
+    std::vector<int> rl = document.rightmost();
+
+    auto size = [&](int u) {
+        return rl[u] - u + 1;
+    };
+
+    int n = query.n;
+
+    Workspace& ws = Workspace::local();
+
+    // Nodes are visited in pre-order. A subtree that is too large to be a match is skipped over to its
+    // children, otherwise it is solved entirely, and so are its subtrees.
+    int u = 1;
+    while (u <= document.n) {
+        if (static_cast<long long>(size(u)) > static_cast<long long>(n) + bound()) {
+            ++u;
+            continue;
+        }
+
+        // The root of this block is the largest subtree in it, so it decides whether any of them can be a match
+        if (size(u) >= n - bound()) {
+            Tree block(document.pre_order(u, rl[u], std::unordered_set<int>()));
+
+            Workspace::Mark mark = ws.mark();
+            Workspace::Table<int> td = ZhangShasha::ted_complete(query, block, ws);
+
+            for (int x = 1; x <= block.n; ++x) {
+                Match m{u + x - 1, td[1][x]};
+
+                if (m.distance > bound() || (k > 0 && best.size() == k && !worse(m, *std::prev(best.end())))) {
+                    continue;
+                }
+
+                best.insert(m);
+                on_update(m, true);
+
+                if (k > 0 && best.size() > k) {
+                    Match evicted = *std::prev(best.end());
+                    best.erase(std::prev(best.end()));
+
+                    on_update(evicted, false);
+                }
+            }
+
+            ws.release(mark);
+        }
+
+        u = rl[u] + 1;
+    }
+
+    return std::vector<Match>(best.begin(), best.end());
+}
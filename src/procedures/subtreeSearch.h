@@ -0,0 +1,50 @@
+#ifndef SUBTREESEARCH_H
+#define SUBTREESEARCH_H
+
+#include <tree.h>
+#include <vector>
+#include <functional>
+
+namespace SubtreeSearch {
+    /**
+     * A subtree of the document along with its distance to the query.
+    */
+    struct Match {
+        // Id of the root of the subtree in the document.
+        int node;
+        // Tree edit distance between the query and the subtree.
+        int distance;
+    };
+
+    /**
+     * Finds the k subtrees of a document closest to a query tree under the Tree Edit Distance (TED).
+     * 
+     * The document is cut into the largest subtrees that still fit within the threshold, and ZhangShasha is
+     * run once for each of them against the query. Since ZhangShasha computes the distance between every pair of
+     * subtrees, this gives the distance from the query to every subtree of the document that is small enough.
+     * 
+     * A subtree of size s is at least |s - |Q|| away from the query Q. Once k matches are found the threshold
+     * shrinks to the distance of the k-th best one, and every part of the document whose subtrees are too
+     * small to beat it is skipped.
+     * 
+     * Ties are broken by the id of the subtree root.
+     * 
+     * @param query An ordered labeled rooted tree
+     * @param document An ordered labeled rooted tree
+     * @param k The number of matches to find. If it is not positive, every match within the threshold is found
+     * @param tau The largest distance allowed for a match
+     * @param on_update A function called as soon as a subtree enters the best k matches found so far, with
+     * added set to true, and when it is pushed out by a better one, with added set to false
+     * 
+     * @returns The matches sorted by distance and then by id.
+    */
+    std::vector<Match> search(
+        const Tree& query,
+        const Tree& document,
+        int k,
+        int tau,
+        const std::function<void(const Match& match, bool added)>& on_update
+    );
+}
+
+#endif
@@ -0,0 +1,148 @@
+#include <tinyTed.h>
+#include <algorithm>
+
+template <int N>
+bool TinyTed::prepare(const Tree& t, Small<N>& s) {
+    if (t.n > N) {
+        return false;
+    }
+
+    s.n = t.n;
+    s.count = 0;
+
+    for (int u = 1; u <= t.n; ++u) {
+        s.labels[u] = t.labels[u];
+        s.rightmost[u] = 0;
+    }
+
+    // Going backwards in pre-order, the last child of a node is the first one seen, and its rightmost leaf is
+    // already known
+    for (int u = t.n; u >= 1; --u) {
+        if (s.rightmost[u] == 0) {
+            s.rightmost[u] = u;
+        }
+
+        int p = t.parent[u];
+
+        if (p > 0 && s.rightmost[p] == 0) {
+            s.rightmost[p] = s.rightmost[u];
+        }
+    }
+
+    for (int u = t.n; u >= 1; --u) {
+        int p = t.parent[u];
+
+        if (p == 0 || s.rightmost[p] != s.rightmost[u]) {
+            s.keyroots[s.count++] = u;
+        }
+    }
+
+    return true;
+}
+
+template <int N>
+void TinyTed::ted_complete(const Small<N>& a, const Small<N>& b, std::uint8_t (&td)[N + 1][N + 1]) {
+    std::uint8_t fd[N + 2][N + 2];
+
+    for (int x = 0; x < a.count; ++x) {
+        int k = a.keyroots[x];
+        int rk = a.rightmost[k];
+
+        for (int y = 0; y < b.count; ++y) {
+            int l = b.keyroots[y];
+            int rl = b.rightmost[l];
+
+            fd[rk + 1][rl + 1] = 0;
+            for (int i = rk; i >= k; --i) {
+                // deletions
+                fd[i][rl + 1] = fd[i + 1][rl + 1] + 1;
+            }
+            for (int j = rl; j >= l; --j) {
+                // insertions
+                fd[rk + 1][j] = fd[rk + 1][j + 1] + 1;
+            }
+
+            for (int i = rk; i >= k; --i) {
+                std::uint8_t* row = fd[i];
+                const std::uint8_t* below = fd[i + 1];
+                const std::uint8_t* jump = fd[a.rightmost[i] + 1];
+                std::uint8_t* trees = td[i];
+
+                int label = a.labels[i];
+                bool tree = a.rightmost[i] == rk;
+
+                // The cell to the right is carried in a register rather than read back from the row
+                int right = row[rl + 1];
+
+                for (int j = rl; j >= l; --j) {
+                    int d = std::min(below[j], static_cast<std::uint8_t>(right)) + 1;
+
+                    if (tree && b.rightmost[j] == rl) {
+                        d = std::min(d, below[j + 1] + (label == b.labels[j] ? 0 : 1));
+                        trees[j] = d;
+                    } else {
+                        d = std::min(d, jump[b.rightmost[j] + 1] + trees[j]);
+                    }
+
+                    row[j] = d;
+                    right = d;
+                }
+            }
+        }
+    }
+}
+
+template <int N>
+int TinyTed::ted(const Small<N>& a, const Small<N>& b) {
+    std::uint8_t td[N + 1][N + 1];
+
+    ted_complete(a, b, td);
+
+    return td[1][1];
+}
+
+namespace {
+    /**
+     * Compares T1 and T2 with the specialization for trees of at most N nodes.
+    */
+    template <int N>
+    int run(const Tree& t1, const Tree& t2) {
+        TinyTed::Small<N> a;
+        TinyTed::Small<N> b;
+
+        TinyTed::prepare(t1, a);
+        TinyTed::prepare(t2, b);
+
+        return TinyTed::ted(a, b);
+    }
+}
+
+bool TinyTed::ted(const Tree& t1, const Tree& t2, int& d) {
+    int n = std::max(t1.n, t2.n);
+
+    if (t1.n == 0 || t2.n == 0 || n > MAX_NODES) {
+        return false;
+    }
+
+    if (n <= 16) {
+        d = run<16>(t1, t2);
+    } else if (n <= 32) {
+        d = run<32>(t1, t2);
+    } else {
+        d = run<64>(t1, t2);
+    }
+
+    return true;
+}
+
+template bool TinyTed::prepare(const Tree&, Small<16>&);
+template bool TinyTed::prepare(const Tree&, Small<32>&);
+template bool TinyTed::prepare(const Tree&, Small<64>&);
+
+template void TinyTed::ted_complete(const Small<16>&, const Small<16>&, std::uint8_t (&)[17][17]);
+template void TinyTed::ted_complete(const Small<32>&, const Small<32>&, std::uint8_t (&)[33][33]);
+template void TinyTed::ted_complete(const Small<64>&, const Small<64>&, std::uint8_t (&)[65][65]);
+
+template int TinyTed::ted(const Small<16>&, const Small<16>&);
+template int TinyTed::ted(const Small<32>&, const Small<32>&);
+template int TinyTed::ted(const Small<64>&, const Small<64>&);
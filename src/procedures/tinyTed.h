@@ -0,0 +1,72 @@
+#ifndef TINYTED_H
+#define TINYTED_H
+
+#include <tree.h>
+#include <cstdint>
+
+/**
+ * Computes the Tree Edit Distance (TED) between trees with at most MAX_NODES nodes without touching the heap.
+ *
+ * For such trees, deriving the structural arrays and obtaining the tables costs as much as filling them. Here every
+ * array has a capacity fixed at compile time and lives on the stack, and so do the tables, whose rows have a
+ * constant stride. Distances are at most 2 * MAX_NODES, so cells are 8 bits wide and the largest tables take a few
+ * kilobytes. There is one specialization for each capacity in 16, 32 and 64, and the smallest one that fits the
+ * larger tree is used.
+ *
+ * The recurrence is the same as in ZhangShasha, with trees decomposed along their rightmost paths.
+*/
+namespace TinyTed {
+    // Largest number of nodes of a tree that can be compared.
+    const int MAX_NODES = 64;
+
+    /**
+     * A tree of at most N nodes along with its structural arrays. Nodes are numbered in pre-order from 1.
+    */
+    template <int N>
+    struct Small {
+        // Number of nodes.
+        int n;
+        // Number of keyroots.
+        int count;
+        // Maps a node to its label.
+        int labels[N + 1];
+        // Maps a node to its rightmost leaf.
+        int rightmost[N + 1];
+        // Keyroots for the rightmost leaves in decreasing order.
+        int keyroots[N];
+    };
+
+    /**
+     * Copies T and derives its structural arrays.
+     *
+     * @returns Whether T has at most N nodes. Otherwise s is left unspecified
+    */
+    template <int N>
+    bool prepare(const Tree& t, Small<N>& s);
+
+    /**
+     * Fills td with the tree edit distance between every pair of subtrees of A and B, where td[i][j] holds the
+     * distance between the subtrees rooted at node i of A and node j of B.
+    */
+    template <int N>
+    void ted_complete(const Small<N>& a, const Small<N>& b, std::uint8_t (&td)[N + 1][N + 1]);
+
+    /**
+     * Computes the TED between A and B.
+    */
+    template <int N>
+    int ted(const Small<N>& a, const Small<N>& b);
+
+    /**
+     * Computes the TED between T1 and T2 with the smallest specialization that fits both trees.
+     *
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param d The tree edit distance between t1 and t2, if both are small enough
+     *
+     * @returns Whether both trees have between 1 and MAX_NODES nodes
+    */
+    bool ted(const Tree& t1, const Tree& t2, int& d);
+}
+
+#endif
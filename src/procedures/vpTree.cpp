@@ -0,0 +1,300 @@
+#include <vpTree.h>
+#include <zhangShasha.h>
+#include <parallel.h>
+#include <algorithm>
+#include <fstream>
+#include <limits>
+#include <queue>
+#include <cstdint>
+
+// Identifies files written by VPTree::save
+static const char MAGIC[8] = {'T', 'E', 'D', 'V', 'P', 'T', '1', '\0'};
+
+VPTree::VPTree() {
+    root = -1;
+}
+
+VPTree::VPTree(const Corpus& corpus, int threads) : corpus(corpus) {
+    root = -1;
+
+    if (corpus.empty()) {
+        return;
+    }
+
+    // items holds positions in the corpus. Every pending node of the index owns a range of it, where
+    // the first position of the range is its vantage point.
+    struct Pending {
+        int node;
+        int lo;
+        int hi;
+    };
+
+    std::vector<int> items(corpus.size());
+    std::vector<int> dist(corpus.size());
+
+    for (int i = 0; i < items.size(); ++i) {
+        items[i] = i;
+    }
+
+    nodes.push_back(Node{items[0], 0, -1, -1});
+    root = 0;
+
+    std::vector<Pending> level = {Pending{0, 0, static_cast<int>(items.size())}};
+
+    while (!level.empty()) {
+        // Compute the distance from every tree to the vantage point of its node for the whole level at once,
+        // so that even the lower levels with many small nodes keep every thread busy
+        std::vector<int> positions;
+        std::vector<int> owner;
+
+        for (int p = 0; p < level.size(); ++p) {
+            for (int x = level[p].lo + 1; x < level[p].hi; ++x) {
+                positions.push_back(x);
+                owner.push_back(p);
+            }
+        }
+
+        Parallel::for_each(positions.size(), [&](int i) {
+            int x = positions[i];
+            const Pending& p = level[owner[i]];
+
+            dist[items[x]] = ZhangShasha::ted(corpus.tree(items[p.lo]), corpus.tree(items[x]));
+        }, threads);
+
+        std::vector<Pending> next;
+
+        for (const Pending& p: level) {
+            int lo = p.lo + 1;
+            int hi = p.hi;
+
+            if (lo == hi) {
+                continue;
+            }
+
+            // Split the remaining trees by the median distance to the vantage point
+            int mid = lo + (hi - lo - 1) / 2;
+            std::nth_element(items.begin() + lo, items.begin() + mid, items.begin() + hi, [&](int x, int y) {
+                return dist[x] < dist[y];
+            });
+
+            int mu = dist[items[mid]];
+            auto split = std::partition(items.begin() + lo, items.begin() + hi, [&](int x) {
+                return dist[x] <= mu;
+            }) - items.begin();
+
+            nodes[p.node].mu = mu;
+
+            if (split > lo) {
+                nodes[p.node].inside = nodes.size();
+                nodes.push_back(Node{items[lo], 0, -1, -1});
+                next.push_back(Pending{nodes[p.node].inside, lo, static_cast<int>(split)});
+            }
+
+            if (split < hi) {
+                nodes[p.node].outside = nodes.size();
+                nodes.push_back(Node{items[split], 0, -1, -1});
+                next.push_back(Pending{nodes[p.node].outside, static_cast<int>(split), hi});
+            }
+        }
+
+        level = next;
+    }
+}
+
+namespace {
+    /**
+     * Visits the index looking for trees within distance r of q. If k is positive, only the k closest trees are
+     * kept and r shrinks to the distance of the k-th closest tree found so far.
+    */
+    std::vector<std::pair<int, int>> search(const VPTree& index, const Tree& q, int k, int r, long long& evaluations) {
+        // max heap of the best results so far
+        std::priority_queue<std::pair<int, int>> best;
+
+        auto radius = [&]() {
+            return k > 0 && best.size() == k ? std::min(r, best.top().first) : r;
+        };
+
+        // Pending nodes along with the bounds their distance to q must satisfy to hold any result.
+        // The lower bound is checked against the radius when the node is visited, since it may have shrunk.
+        struct Visit {
+            int node;
+            int lower;
+        };
+
+        std::vector<Visit> stack;
+        if (index.root >= 0) {
+            stack.push_back(Visit{index.root, 0});
+        }
+
+        while (!stack.empty()) {
+            Visit v = stack.back();
+            stack.pop_back();
+
+            if (v.lower > radius()) {
+                continue;
+            }
+
+            const VPTree::Node& node = index.nodes[v.node];
+
+            int d = ZhangShasha::ted(q, index.corpus.tree(node.item));
+            ++evaluations;
+
+            if (d <= radius()) {
+                best.push({d, node.item});
+
+                if (k > 0 && best.size() > k) {
+                    best.pop();
+                }
+            }
+
+            // Trees inside are at least d - mu away from q, and trees outside at least mu + 1 - d
+            int inside = std::max(0, d - node.mu);
+            int outside = std::max(0, node.mu + 1 - d);
+
+            // Push the farthest child first so the nearest one is visited first
+            if (d <= node.mu) {
+                if (node.outside >= 0) stack.push_back(Visit{node.outside, outside});
+                if (node.inside >= 0) stack.push_back(Visit{node.inside, inside});
+            } else {
+                if (node.inside >= 0) stack.push_back(Visit{node.inside, inside});
+                if (node.outside >= 0) stack.push_back(Visit{node.outside, outside});
+            }
+        }
+
+        std::vector<std::pair<int, int>> result;
+        while (!best.empty()) {
+            result.push_back(best.top());
+            best.pop();
+        }
+
+        std::sort(result.begin(), result.end());
+
+        return result;
+    }
+}
+
+std::vector<std::pair<int, int>> VPTree::knn(const Tree& q, int k, long long& evaluations) const {
+    if (k <= 0) {
+        return std::vector<std::pair<int, int>>();
+    }
+
+    return search(*this, q, k, std::numeric_limits<int>::max(), evaluations);
+}
+
+std::vector<std::pair<int, int>> VPTree::range(const Tree& q, int r, long long& evaluations) const {
+    return search(*this, q, 0, r, evaluations);
+}
+
+bool VPTree::save(const std::string& path) const {
+    std::ofstream out(path, std::ios::binary);
+
+    if (!out) {
+        return false;
+    }
+
+    auto write = [&](std::int32_t x) {
+        out.write(reinterpret_cast<const char*>(&x), sizeof(x));
+    };
+
+    out.write(MAGIC, sizeof(MAGIC));
+
+    write(corpus.size());
+    for (int i = 0; i < corpus.size(); ++i) {
+        std::string pre_order = corpus.pre_order(i);
+
+        write(pre_order.size());
+        out.write(pre_order.data(), pre_order.size());
+    }
+
+    write(nodes.size());
+    for (const Node& node: nodes) {
+        write(node.item);
+        write(node.mu);
+        write(node.inside);
+        write(node.outside);
+    }
+
+    write(root);
+
+    return static_cast<bool>(out);
+}
+
+bool VPTree::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary | std::ios::ate);
+
+    // Every count and length read from the file is checked against the bytes left in it before anything is
+    // allocated, so that a damaged file cannot ask for more memory than its own size
+    std::streamoff size = in.tellg();
+    in.seekg(0);
+
+    char magic[sizeof(MAGIC)];
+    if (!in.read(magic, sizeof(magic)) || !std::equal(magic, magic + sizeof(magic), MAGIC)) {
+        return false;
+    }
+
+    auto read = [&]() {
+        std::int32_t x = 0;
+        in.read(reinterpret_cast<char*>(&x), sizeof(x));
+        return x;
+    };
+
+    // Checks that a count of items of the given size fits in the rest of the file
+    auto fits = [&](std::int32_t count, std::streamoff item) {
+        return in && count >= 0 && count * item <= size - static_cast<std::streamoff>(in.tellg());
+    };
+
+    corpus = Corpus();
+    nodes.clear();
+    root = -1;
+
+    int count = read();
+    if (!fits(count, sizeof(std::int32_t))) {
+        return false;
+    }
+
+    for (int i = 0; i < count; ++i) {
+        std::int32_t length = read();
+        if (!fits(length, 1)) {
+            return false;
+        }
+
+        std::string pre_order(length, '\0');
+        in.read(&pre_order[0], pre_order.size());
+
+        if (!in || !Tree::valid(pre_order)) {
+            return false;
+        }
+
+        corpus.add(pre_order);
+    }
+
+    corpus.shrink_to_fit();
+
+    count = read();
+    if (!fits(count, 4 * sizeof(std::int32_t))) {
+        return false;
+    }
+
+    nodes.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        Node node;
+        node.item = read();
+        node.mu = read();
+        node.inside = read();
+        node.outside = read();
+
+        // Children always come after their parent, which also rules out cycles
+        bool child = (node.inside == -1 || (node.inside > i && node.inside < count))
+            && (node.outside == -1 || (node.outside > i && node.outside < count));
+
+        if (node.item < 0 || node.item >= corpus.size() || !child) {
+            return false;
+        }
+
+        nodes.push_back(node);
+    }
+
+    root = read();
+
+    return in && root >= -1 && root < static_cast<int>(nodes.size()) && (root == -1) == nodes.empty();
+}
@@ -0,0 +1,101 @@
+#ifndef VPTREE_H
+#define VPTREE_H
+
+#include <tree.h>
+#include <corpus.h>
+#include <vector>
+#include <string>
+#include <utility>
+
+/**
+ * A vantage point tree over a corpus of trees. It answers nearest neighbor and range queries under the
+ * Tree Edit Distance (TED) while skipping most of the corpus.
+ * 
+ * Every node of the index holds a vantage point v from the corpus and the median distance mu from v to the trees
+ * below it. Trees within distance mu of v go to the inside child, and the rest to the outside child. Since TED is
+ * a metric, the triangle inequality tells which children may hold trees within distance r of a query q:
+ * 
+ *      - the inside child, only if TED(q, v) - r <= mu
+ *      - the outside child, only if TED(q, v) + r > mu
+ * 
+ * The index can be saved to disk and loaded back so that it is only built once.
+*/
+struct VPTree {
+    /**
+     * A node of the index.
+    */
+    struct Node {
+        // Position of the vantage point in the corpus.
+        int item;
+        // Median distance from the vantage point to the trees below it.
+        int mu;
+        // Index of the child that holds trees within distance mu, or -1 if there is none.
+        int inside;
+        // Index of the child that holds trees further than mu, or -1 if there is none.
+        int outside;
+    };
+
+    // Trees indexed by this structure. Each one is expanded only while a distance to it is computed.
+    Corpus corpus;
+
+    // Nodes of the index.
+    std::vector<Node> nodes;
+
+    // Index of the root node, or -1 if the corpus is empty.
+    int root;
+
+    /**
+     * Constructs an empty index.
+    */
+    VPTree();
+
+    /**
+     * Builds the index over the given corpus.
+     * 
+     * The index is built one level at a time, and the distances needed for every node of a level are computed
+     * in parallel. It requires O(nlgn) distance evaluations where n is the number of trees in the corpus.
+     * 
+     * @param corpus The trees to index
+     * @param threads The number of threads to use. If it is not positive, all hardware threads are used
+    */
+    VPTree(const Corpus& corpus, int threads = 0);
+
+    /**
+     * Finds the k trees in the corpus closest to the query.
+     * 
+     * @param q An ordered labeled rooted tree
+     * @param k The number of neighbors to find
+     * @param evaluations A counter that is increased by the number of distances computed
+     * 
+     * @returns Pairs of distance and position in the corpus sorted by distance and then by position
+    */
+    std::vector<std::pair<int, int>> knn(const Tree& q, int k, long long& evaluations) const;
+
+    /**
+     * Finds every tree in the corpus within distance r of the query.
+     * 
+     * @param q An ordered labeled rooted tree
+     * @param r The largest distance allowed
+     * @param evaluations A counter that is increased by the number of distances computed
+     * 
+     * @returns Pairs of distance and position in the corpus sorted by distance and then by position
+    */
+    std::vector<std::pair<int, int>> range(const Tree& q, int r, long long& evaluations) const;
+
+    /**
+     * Writes the corpus and the index to a binary file.
+     * 
+     * @returns Whether the file could be written
+    */
+    bool save(const std::string& path) const;
+
+    /**
+     * Reads a corpus and an index written by save. Counts, lengths, trees and node links are checked before they
+     * are used, so a damaged file is refused rather than read.
+     * 
+     * @returns Whether the file could be read
+    */
+    bool load(const std::string& path);
+};
+
+#endif
@@ -1,26 +1,524 @@
 #include <zhangShasha.h>
+#include <subtreeTable.h>
+#include <tinyTed.h>
 #include <algorithm>
+#include <atomic>
+#include <type_traits>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <unistd.h>
 
 int min(int a, int b, int c);
 
+namespace {
+    // Side of the tiles used for large fd tables, or 0 if it has not been detected yet
+    std::atomic<int> tile(0);
+
+    // Smallest |T1| * |T2| for which identical subtrees are looked for. Below it, hashing every subtree costs
+    // more than the pairs of keyroots it could save.
+    const long long MIN_REUSE_CELLS = 1 << 14;
+
+    // Number of forest distance cells filled between two checks of a cancellation token or a checkpoint schedule,
+    // so that reading the clock does not show up next to the pairs of small keyroots
+    const long long CHECK_CELLS = 1 << 16;
+
+    /**
+     * Tells a fill where to start and what to do every so often between two pairs of keyroots. Pairs are numbered
+     * in the order they are done, so the pair of the x-th keyroot of T1 and the y-th keyroot of T2 is number
+     * x * (number of keyroots of T2) + y.
+    */
+    struct Steps {
+        // Number of the first pair to compute. Every pair before it is assumed to be done already.
+        long long first = 0;
+        // Number of pairs, which is set by the fill.
+        long long count = 0;
+        // Called every CHECK_CELLS cells with the number of the next pair, once every pair before it is done.
+        // The fill stops if it returns false.
+        std::function<bool(long long)> between;
+    };
+
+    /**
+     * Computes the rightmost leaf of each node u in the sub-forest T(l, r). Subtrees that go past r are cut at r.
+     *
+     * Nodes are processed in reverse pre-order so that every child is visited before its parent.
+    */
+    Workspace::Array<int> rightmost(const Tree& t, int l, int r, Workspace& ws) {
+        Workspace::Array<int> rl = ws.array<int>(l, r);
+
+        for (int u = r; u >= l; --u) {
+            rl[u] = u;
+
+            for (int c = t.adj[u].size() - 1; c >= 0; --c) {
+                if (t.adj[u][c] <= r) {
+                    rl[u] = rl[t.adj[u][c]];
+                    break;
+                }
+            }
+        }
+
+        return rl;
+    }
+
+    /**
+     * Computes the keyroots_r of T in decreasing order given its rightmost leaves.
+     *
+     * A node is a keyroot if it is the root of a tree in the forest or if it is not the last child of its parent.
+    */
+    Workspace::Array<int> keyroots(const Tree& t, const Workspace::Array<int>& rl, Workspace& ws) {
+        Workspace::Array<int> kr = ws.array<int>(0, t.n - 1);
+
+        int size = 0;
+        for (int u = t.n; u >= 1; --u) {
+            int p = t.parent[u];
+
+            if (p == 0 || rl[p] != rl[u]) {
+                kr[size++] = u;
+            }
+        }
+
+        kr.hi = size - 1;
+
+        return kr;
+    }
+
+    /**
+     * Finds the first of the given keyroots with each canonical id. Ids that no keyroot has are mapped to 0.
+    */
+    Workspace::Array<int> first_keyroots(Workspace::Array<const int> keyroots, const std::vector<int>& ids, int size, Workspace& ws) {
+        Workspace::Array<int> first = ws.array<int>(0, size - 1);
+        std::fill(first.data, first.data + size, 0);
+
+        for (int x = keyroots.lo; x <= keyroots.hi; ++x) {
+            int& f = first[ids[keyroots[x]]];
+            f = f == 0 ? keyroots[x] : f;
+        }
+
+        return first;
+    }
+
+    /**
+     * Copies the tree edit distances between the nodes on the rightmost paths of keyroots ks and ls to the nodes
+     * at the same offsets on the rightmost paths of keyroots k and l, whose subtrees are identical.
+    */
+    template <typename TD>
+    void copy_pair(const Tree& t1, const Tree& t2, int k, int l, int ks, int ls, TD& td) {
+        for (int i = k; ; i = t1.adj[i].back()) {
+            for (int j = l; ; j = t2.adj[j].back()) {
+                td[i][j] = td[i - k + ks][j - l + ls];
+
+                if (t2.adj[j].empty()) {
+                    break;
+                }
+            }
+
+            if (t1.adj[i].empty()) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Fills the tree edit distances between the nodes on the rightmost paths of keyroots k and l, whose subtrees
+     * are identical, without any forest distances.
+     *
+     * Nodes at the same offset of both paths root identical subtrees, at distance 0. Otherwise, the subtree of
+     * the deeper node is identical to a subtree on the rightmost path of the other one, which is turned into it
+     * by deleting every other node. No edit script does better than the difference of their sizes, so that
+     * difference is the distance.
+    */
+    template <typename TD>
+    void identical_pair(const Tree& t1, const Tree& t2, int k, int l, TD& td) {
+        for (int i = k; ; i = t1.adj[i].back()) {
+            for (int j = l; ; j = t2.adj[j].back()) {
+                td[i][j] = std::abs((i - k) - (j - l));
+
+                if (t2.adj[j].empty()) {
+                    break;
+                }
+            }
+
+            if (t1.adj[i].empty()) {
+                break;
+            }
+        }
+    }
+
+    /**
+     * Fills td with the tree edit distance between every node of T1 on the rightmost path of one of the given
+     * keyroots and every node of T2. Keyroots must be given in decreasing order.
+     *
+     * The forest distances for each pair of keyroots are kept in a table sized to the keyroot ranges that is
+     * released as soon as the pair is done. Its cells have the same type as the cells of td.
+     *
+     * If canonical ids from a table shared by both trees are given, a pair of keyroots whose subtrees are
+     * identical to each other is filled directly, and a pair of keyroots whose subtrees are identical to those of
+     * a pair done before is not computed again. The distances found for the earlier pair
+     * are copied along the rightmost paths instead, since nodes at the same offset of identical subtrees root
+     * identical subtrees as well.
+     *
+     * If steps are given, pairs before the first one are skipped, and the fill stops as soon as the callback
+     * between pairs returns false. Returns whether every pair was done.
+    */
+    template <typename TD>
+    bool ted_fill(
+        const Tree& t1,
+        const Tree& t2,
+        Workspace::Array<const int> t1_rightmost,
+        Workspace::Array<const int> t1_keyroots,
+        Workspace::Array<const int> t2_rightmost,
+        Workspace::Array<const int> t2_keyroots,
+        TD& td,
+        Workspace& ws,
+        const std::vector<int>* t1_ids = nullptr,
+        const std::vector<int>* t2_ids = nullptr,
+        Steps* steps = nullptr
+    ) {
+        typedef typename std::remove_reference<decltype(td[0][0])>::type Cell;
+
+        // The first keyroot processed with each id, which is the one every later keyroot with that id reuses
+        Workspace::Array<int> t1_first{nullptr, 0, -1};
+        Workspace::Array<int> t2_first{nullptr, 0, -1};
+
+        if (t1_ids != nullptr && t2_ids != nullptr) {
+            int size = 0;
+            for (int x = t1_keyroots.lo; x <= t1_keyroots.hi; ++x) {
+                size = std::max(size, (*t1_ids)[t1_keyroots[x]] + 1);
+            }
+            for (int y = t2_keyroots.lo; y <= t2_keyroots.hi; ++y) {
+                size = std::max(size, (*t2_ids)[t2_keyroots[y]] + 1);
+            }
+
+            t1_first = first_keyroots(t1_keyroots, *t1_ids, size, ws);
+            t2_first = first_keyroots(t2_keyroots, *t2_ids, size, ws);
+        }
+
+        int t2_count = t2_keyroots.hi - t2_keyroots.lo + 1;
+
+        if (steps != nullptr) {
+            steps->count = static_cast<long long>(t1_keyroots.hi - t1_keyroots.lo + 1) * t2_count;
+        }
+
+        // Cells filled since the steps were last told
+        long long work = 0;
+
+        for (int x = t1_keyroots.lo; x <= t1_keyroots.hi; ++x) {
+            int k = t1_keyroots[x];
+            int rk = t1_rightmost[k];
+
+            // Keyroot of T1 with the same subtree as k that was processed first
+            int ks = t1_first.data != nullptr ? t1_first[(*t1_ids)[k]] : k;
+
+            for (int y = t2_keyroots.lo; y <= t2_keyroots.hi; ++y) {
+                int l = t2_keyroots[y];
+                int rl = t2_rightmost[l];
+
+                int ls = t2_first.data != nullptr ? t2_first[(*t2_ids)[l]] : l;
+
+                long long pair = static_cast<long long>(x - t1_keyroots.lo) * t2_count + (y - t2_keyroots.lo);
+
+                if (steps != nullptr && pair < steps->first) {
+                    continue;
+                }
+
+                if (t1_first.data != nullptr && (*t1_ids)[k] == (*t2_ids)[l]) {
+                    identical_pair(t1, t2, k, l, td);
+                    continue;
+                }
+
+                if (ks != k || ls != l) {
+                    // Keyroots are processed in decreasing order, so the pair (ks, ls) is already done
+                    copy_pair(t1, t2, k, l, ks, ls, td);
+                    continue;
+                }
+
+                if (steps != nullptr && (work += static_cast<long long>(rk - k + 2) * (rl - l + 2)) >= CHECK_CELLS) {
+                    work = 0;
+
+                    if (!steps->between(pair)) {
+                        return false;
+                    }
+                }
+
+                Workspace::Mark mark = ws.mark();
+                Workspace::Table<Cell> fd = ws.table<Cell>(k, rk + 1, l, rl + 1);
+
+                fd[rk + 1][rl + 1] = 0;
+                for (int i = rk; i >= k; --i) {
+                    // deletions
+                    fd[i][rl + 1] = fd[i + 1][rl + 1] + 1;
+                }
+                for (int j = rl; j >= l; --j) {
+                    // insertions
+                    fd[rk + 1][j] = fd[rk + 1][j + 1] + 1;
+                }
+
+                // Fills the cells of row i from column jr down to column jl
+                //
+                // Everything the loop reads is copied to locals first. Cells may be 8 bits wide, and a store through
+                // a char type could alias anything that is only reachable through a reference.
+                auto fill = [&](int i, int jr, int jl) {
+                    auto row = fd[i];
+                    auto below = fd[i + 1];
+                    auto jump = fd[t1_rightmost[i] + 1];
+                    auto&& trees = td[i];
+
+                    Workspace::Array<const int> right2 = t2_rightmost;
+                    const int* labels2 = t2.labels.data();
+                    int label1 = t1.labels[i];
+                    int last = rl;
+
+                    bool tree = t1_rightmost[i] == rk;
+
+                    // The cell to the right is carried in a register rather than read back from the row
+                    int right = row[jr + 1];
+
+                    for (int j = jr; j >= jl; --j) {
+                        int d;
+
+                        if (tree && right2[j] == last) {
+                            d = min(
+                                below[j] + 1, // insert
+                                right + 1, // delete
+                                below[j+1] + (label1 == labels2[j] ? 0 : 1) // relabel
+                            );
+                            trees[j] = d;
+                        } else {
+                            d = min(
+                                below[j] + 1, // insert
+                                right + 1, // delete
+                                jump[right2[j] + 1] + trees[j] // relabel
+                            );
+                        }
+
+                        row[j] = d;
+                        right = d;
+                    }
+                };
+
+                int b = ZhangShasha::tile_size();
+
+                if (rl - l < b) {
+                    for (int i = rk; i >= k; --i) {
+                        fill(i, rl, l);
+                    }
+                } else {
+                    // Every cell depends on cells below it, to its right, or at (rightmost(i) + 1, rightmost(j) + 1),
+                    // which are all in tiles that come earlier when tiles are visited bottom up and right to left
+                    for (int ti = rk; ti >= k; ti -= b) {
+                        for (int tj = rl; tj >= l; tj -= b) {
+                            for (int i = ti; i >= k && i > ti - b; --i) {
+                                fill(i, tj, std::max(l, tj - b + 1));
+                            }
+                        }
+                    }
+                }
+
+                ws.release(mark);
+            }
+        }
+
+        return true;
+    }
+
+    /**
+     * Fills td with the tree edit distance between every pair of subtrees of T1 and T2. Returns whether every
+     * pair was done before the steps, if any, stopped the fill.
+    */
+    template <typename TD>
+    bool ted_fill(const Tree& t1, const Tree& t2, TD& td, Workspace& ws, Steps* steps = nullptr) {
+        Workspace::Array<int> t1_rightmost = rightmost(t1, 1, t1.n, ws);
+        Workspace::Array<int> t1_keyroots = keyroots(t1, t1_rightmost, ws);
+
+        Workspace::Array<int> t2_rightmost = rightmost(t2, 1, t2.n, ws);
+        Workspace::Array<int> t2_keyroots = keyroots(t2, t2_rightmost, ws);
+
+        if (static_cast<long long>(t1.n) * t2.n < MIN_REUSE_CELLS) {
+            return ted_fill(t1, t2, t1_rightmost, t1_keyroots, t2_rightmost, t2_keyroots, td, ws, nullptr, nullptr, steps);
+        }
+
+        // Identical subtrees get the same id in both trees, so that repeated pairs of keyroots are skipped
+        SubtreeTable table;
+        std::vector<int> t1_ids = table.canonical(t1);
+        std::vector<int> t2_ids = table.canonical(t2);
+
+        return ted_fill(t1, t2, t1_rightmost, t1_keyroots, t2_rightmost, t2_keyroots, td, ws, &t1_ids, &t2_ids, steps);
+    }
+
+    /**
+     * Gets a view over the rightmost leaves of a prepared tree.
+    */
+    Workspace::Array<const int> rightmost(const PreparedTree& t) {
+        return Workspace::Array<const int>{t.rightmost.data(), 0, static_cast<int>(t.rightmost.size()) - 1};
+    }
+
+    /**
+     * Gets a view over the keyroots of a prepared tree.
+    */
+    Workspace::Array<const int> keyroots(const PreparedTree& t) {
+        return Workspace::Array<const int>{t.keyroots.data(), 0, static_cast<int>(t.keyroots.size()) - 1};
+    }
+
+    /**
+     * Fills fd with the forest edit distance between F1 = T1(i, ir) and F2 = T2(j, jr) for every il <= i <= ir + 1
+     * and jl <= j <= jr + 1.
+    */
+    template <typename TD, typename FD>
+    void fed_fill(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const TD& td, FD& fd, Workspace& ws) {
+        // Recompute rightmost leaf for nodes based on the intervals
+        Workspace::Array<int> t1_rightmost = rightmost(t1, il, ir, ws);
+        Workspace::Array<int> t2_rightmost = rightmost(t2, jl, jr, ws);
+
+        fd[ir+1][jr+1] = 0;
+        for (int i = ir; i >= il; --i) {
+            // deletions
+            fd[i][jr+1] = fd[i+1][jr+1] + 1;
+        }
+        for (int j = jr; j >= jl; --j) {
+            // insertions
+            fd[ir+1][j] = fd[ir+1][j+1] + 1;
+        }
+        for (int i = ir; i >= il; --i) {
+            for (int j = jr; j >= jl; --j) {
+                fd[i][j] = min(
+                    fd[i+1][j] + 1, // insert
+                    fd[i][j+1] + 1, // delete
+                    fd[t1_rightmost[i]+1][t2_rightmost[j]+1] + td[i][j] // relabel
+                );
+            }
+        }
+    }
+
+    /**
+     * Computes the forest edit distance between F1 = T1(il, ir) and F2 = T2(jl, jr) using a table that only
+     * covers the given ranges.
+    */
+    template <typename TD>
+    int fed_range(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const TD& td, Workspace& ws) {
+        typedef typename std::remove_const<typename std::remove_reference<decltype(td[0][0])>::type>::type Cell;
+
+        Workspace::Mark mark = ws.mark();
+        Workspace::Table<Cell> fd = ws.table<Cell>(il, ir + 1, jl, jr + 1);
+
+        fed_fill(t1, il, ir, t2, jl, jr, td, fd, ws);
+
+        int d = fd[il][jl];
+
+        ws.release(mark);
+
+        return d;
+    }
+}
+
 int ZhangShasha::ted(const Tree& t1, const Tree& t2) {
-    std::vector<std::vector<int>> ted = ZhangShasha::ted_complete(t1, t2);
+    int d = -1;
+
+    // Tiny trees are compared on the stack
+    if (TinyTed::ted(t1, t2, d)) {
+        return d;
+    }
+
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    d = with_cell(t1.n + t2.n, [&](auto cell) -> int {
+        return ZhangShasha::ted_complete<decltype(cell)>(t1, t2, ws)[1][1];
+    });
+
+    ws.release(mark);
+
+    return d;
+}
+
+int ZhangShasha::ted(const Tree& t1, const Tree& t2, const CancelToken& token) {
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    int d = with_cell(t1.n + t2.n, [&](auto cell) -> int {
+        typedef decltype(cell) Cell;
+        Workspace::Table<Cell> td = ws.table<Cell>(1, t1.n, 1, t2.n);
+
+        Steps steps;
+        steps.between = [&](long long) {
+            return !token.expired();
+        };
+
+        return ted_fill(t1, t2, td, ws, &steps) ? td[1][1] : -1;
+    });
+
+    ws.release(mark);
+
+    return d;
+}
+
+int ZhangShasha::ted(const Tree& t1, const Tree& t2, Checkpoints& checkpoints) {
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    Checkpoint c;
+    c.algorithm = "ZhangShasha";
+    c.inputs = Checkpoint::hash(t1, t2);
+    c.rows = t1.n;
+    c.cols = t2.n;
+
+    int d = with_cell(t1.n + t2.n, [&](auto cell) -> int {
+        typedef decltype(cell) Cell;
+        Workspace::Table<Cell> td = ws.table<Cell>(1, t1.n, 1, t2.n);
+
+        Steps steps;
+
+        const Checkpoint& resume = checkpoints.resume;
+        if (!resume.td.empty() && resume.rows == t1.n && resume.cols == t2.n) {
+            for (int i = 1; i <= t1.n; ++i) {
+                for (int j = 1; j <= t2.n; ++j) {
+                    td[i][j] = resume.td[static_cast<std::size_t>(i - 1) * t2.n + j - 1];
+                }
+            }
+
+            steps.first = resume.first();
+        }
+
+        steps.between = [&](long long next) {
+            bool stop = checkpoints.limit >= 0 && next >= checkpoints.limit;
+
+            if (!stop && !checkpoints.due()) {
+                return true;
+            }
+
+            // Pairs are done in order, so the table holds every distance found by the pairs before the next one
+            c.td.resize(static_cast<std::size_t>(t1.n) * t2.n);
+            for (int i = 1; i <= t1.n; ++i) {
+                for (int j = 1; j <= t2.n; ++j) {
+                    c.td[static_cast<std::size_t>(i - 1) * t2.n + j - 1] = td[i][j];
+                }
+            }
+
+            c.done.assign(steps.count, false);
+            std::fill(c.done.begin(), c.done.begin() + next, true);
+
+            checkpoints.save(c);
+
+            if (stop) {
+                checkpoints.stopped = next;
+            }
 
-    return ted[1][1];
+            return !stop;
+        };
+
+        ted_fill(t1, t2, td, ws, &steps);
+
+        return td[1][1];
+    });
+
+    ws.release(mark);
+
+    return d;
 }
 
 std::vector<std::vector<int>> ZhangShasha::ted_complete(const Tree& t1, const Tree& t2) {
     int n = t1.n;
     int m = t2.n;
 
-    std::vector<int> t1_keyroots = t1.keyroots_r();
-    std::reverse(t1_keyroots.begin(), t1_keyroots.end());
-    std::vector<int> t2_keyroots = t2.keyroots_r();
-    std::reverse(t2_keyroots.begin(), t2_keyroots.end());
-
-    std::vector<int> t1_rightmost = t1.rightmost();
-    std::vector<int> t2_rightmost = t2.rightmost();
-
     // use tabulation for computing tree edit distance - TED
     // td[i][j] corresponds to the TED between the subtrees T1 rooted at i and T2 rooted at j
     //
@@ -40,110 +538,164 @@ std::vector<std::vector<int>> ZhangShasha::ted_complete(const Tree& t1, const Tr
     // fd[i][j] = min(
     //      fd[i+1][j] + 1,
     //      fd[i][j+1] + 1,
-    //      fd[rightmost(i) + 1][rightmost(j) + 1] + td[i][j]             
+    //      fd[rightmost(i) + 1][rightmost(j) + 1] + td[i][j]
     // );
-    std::vector<std::vector<int>> fd(n + 2, std::vector<int>(m + 2));
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
 
-    auto cost = [&](int i, int j) {
-        return t1.labels[i] == t2.labels[j] ? 0 : 1;
-    };
+    ted_fill(t1, t2, td, ws);
 
-    for (int k: t1_keyroots) {
-        for (int l: t2_keyroots) {
-            fd[t1_rightmost[k] + 1][t2_rightmost[l] + 1] = 0;
-            for (int i = t1_rightmost[k]; i >= k; --i) {
-                // deletions
-                fd[i][t2_rightmost[l]+1] = fd[i+1][t2_rightmost[l]+1] + 1;
-            }
-            for (int j = t2_rightmost[l]; j >= l; --j) {
-                // insertions
-                fd[t1_rightmost[k]+1][j] = fd[t1_rightmost[k]+1][j+1] + 1;
-            }
-            for (int i = t1_rightmost[k]; i >= k; --i) {
-                for (int j = t2_rightmost[l]; j >= l; --j) {
-                    if (t1_rightmost[i] == t1_rightmost[k] && t2_rightmost[j] == t2_rightmost[l]) {
-                        fd[i][j] = min(
-                            fd[i+1][j] + 1, // insert
-                            fd[i][j+1] + 1, // delete
-                            fd[i+1][j+1] + cost(i, j) // relabel
-                        );
-                        td[i][j] = fd[i][j];
-                    } else {
-                        fd[i][j] = min(
-                            fd[i+1][j] + 1, // insert
-                            fd[i][j+1] + 1, // delete
-                            fd[t1_rightmost[i] + 1][t2_rightmost[j]+1] + td[i][j] // relabel
-                        );
-                    }
-                }
-            }
-        }
-    }
+    ws.release(mark);
+
+    return td;
+}
+
+template <typename Cell>
+Workspace::Table<Cell> ZhangShasha::ted_complete(const Tree& t1, const Tree& t2, Workspace& ws) {
+    Workspace::Table<Cell> td = ws.table<Cell>(1, t1.n, 1, t2.n);
+
+    // scratch arrays are released right away, but td stays alive until the caller releases it
+    Workspace::Mark mark = ws.mark();
+
+    ted_fill(t1, t2, td, ws);
+
+    ws.release(mark);
 
     return td;
 }
 
+void ZhangShasha::ted_partial(const Tree& t1, const Tree& t2, const std::vector<int>& t1_keyroots, std::vector<std::vector<int>>& td) {
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    Workspace::Array<int> t1_rightmost = rightmost(t1, 1, t1.n, ws);
+
+    Workspace::Array<int> roots = ws.array<int>(0, t1_keyroots.size() - 1);
+    for (int x = 0; x < t1_keyroots.size(); ++x) {
+        roots[x] = t1_keyroots[x];
+    }
+
+    Workspace::Array<int> t2_rightmost = rightmost(t2, 1, t2.n, ws);
+    Workspace::Array<int> t2_keyroots = keyroots(t2, t2_rightmost, ws);
+
+    ted_fill(t1, t2, t1_rightmost, roots, t2_rightmost, t2_keyroots, td, ws);
+
+    ws.release(mark);
+}
+
+int ZhangShasha::ted(const PreparedTree& t1, const PreparedTree& t2, Workspace& ws) {
+    int d = -1;
+
+    if (TinyTed::ted(t1.tree, t2.tree, d)) {
+        return d;
+    }
+
+    Workspace::Mark mark = ws.mark();
+
+    d = with_cell(t1.tree.n + t2.tree.n, [&](auto cell) -> int {
+        typedef decltype(cell) Cell;
+        Workspace::Table<Cell> td = ws.table<Cell>(1, t1.tree.n, 1, t2.tree.n);
+
+        ted_fill(t1.tree, t2.tree, rightmost(t1), keyroots(t1), rightmost(t2), keyroots(t2), td, ws);
+
+        return td[1][1];
+    });
+
+    ws.release(mark);
+
+    return d;
+}
+
 int ZhangShasha::fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td) {
-    std::vector<std::vector<int>> ted = ZhangShasha::fed_complete(t1, il, ir, t2, jl, jr, td);
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
+
+    int d = ZhangShasha::fed(t1, il, ir, t2, jl, jr, td, ws);
 
-    return ted[il][jl];
+    ws.release(mark);
+
+    return d;
+}
+
+int ZhangShasha::fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td, Workspace& ws) {
+    return fed_range(t1, il, ir, t2, jl, jr, td, ws);
 }
 
-std::vector<std::vector<int>> ZhangShasha::fed_complete(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td) {
+template <typename Cell>
+int ZhangShasha::fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const Workspace::Table<Cell>& td, Workspace& ws) {
+    return fed_range(t1, il, ir, t2, jl, jr, td, ws);
+}
+
+template <typename Cell>
+std::vector<std::vector<Cell>> ZhangShasha::fed_complete(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<Cell>>& td) {
     int n = t1.n;
     int m = t2.n;
 
     // use tabulation for computing forest edit distance - FED
-    // fd[i][j] corresponds to the FED between the sub-forests T1(i, rightmost(k)) and T2(j, rightmost(l)) for fixed
-    // values of k and l.
-    //
-    // fd[i][j] = td[i][j] for trees, Otherwise it follows that:
+    // fd[i][j] corresponds to the FED between the sub-forests T1(i, ir) and T2(j, jr).
     //
     // fd[i][j] = min(
     //      fd[i+1][j] + 1,
     //      fd[i][j+1] + 1,
-    //      fd[rightmost(i) + 1][rightmost(j) + 1] + td[i][j]             
+    //      fd[rightmost(i) + 1][rightmost(j) + 1] + td[i][j]
     // );
-    std::vector<int> t1_rightmost = t1.rightmost();
-    std::vector<int> t2_rightmost = t2.rightmost();
+    std::vector<std::vector<Cell>> fd(n + 2, std::vector<Cell>(m + 2));
 
-    // Recompute rightmost leaf for nodes based on the intervals
-    for (int i = il; i <= ir; ++i) {
-        t1_rightmost[i] = std::min(t1_rightmost[i], ir);
-    }
+    Workspace& ws = Workspace::local();
+    Workspace::Mark mark = ws.mark();
 
-    for (int j = jl; j <= jr; ++j) {
-        t2_rightmost[j] = std::min(t2_rightmost[j], jr);
-    }
+    fed_fill(t1, il, ir, t2, jl, jr, td, fd, ws);
 
-    std::vector<std::vector<int>> fd(n + 2, std::vector<int>(m + 2, -1));
-    fd[ir+1][jr+1] = 0;
+    ws.release(mark);
 
-    auto cost = [&](int i, int j) {
-        return t1.labels[i] == t2.labels[j] ? 0 : 1;
-    };
+    return fd;
+}
 
-    for (int i = ir; i >= il; --i) {
-        // deletions
-        fd[i][jr+1] = fd[i+1][jr+1] + 1;
-    }
-    for (int j = jr; j >= jl; --j) {
-        // insertions
-        fd[ir+1][j] = fd[ir+1][j+1] + 1;
+// Tables are only made of the cell types that with_cell picks
+template Workspace::Table<std::uint8_t> ZhangShasha::ted_complete(const Tree&, const Tree&, Workspace&);
+template Workspace::Table<std::uint16_t> ZhangShasha::ted_complete(const Tree&, const Tree&, Workspace&);
+template Workspace::Table<int> ZhangShasha::ted_complete(const Tree&, const Tree&, Workspace&);
+
+template int ZhangShasha::fed(const Tree&, int, int, const Tree&, int, int, const Workspace::Table<std::uint8_t>&, Workspace&);
+template int ZhangShasha::fed(const Tree&, int, int, const Tree&, int, int, const Workspace::Table<std::uint16_t>&, Workspace&);
+template int ZhangShasha::fed(const Tree&, int, int, const Tree&, int, int, const Workspace::Table<int>&, Workspace&);
+
+template std::vector<std::vector<std::uint8_t>> ZhangShasha::fed_complete(const Tree&, int, int, const Tree&, int, int, const std::vector<std::vector<std::uint8_t>>&);
+template std::vector<std::vector<std::uint16_t>> ZhangShasha::fed_complete(const Tree&, int, int, const Tree&, int, int, const std::vector<std::vector<std::uint16_t>>&);
+template std::vector<std::vector<int>> ZhangShasha::fed_complete(const Tree&, int, int, const Tree&, int, int, const std::vector<std::vector<int>>&);
+
+int ZhangShasha::tile_size() {
+    int b = tile.load(std::memory_order_relaxed);
+
+    if (b > 0) {
+        return b;
     }
-    for (int i = ir; i >= il; --i) {
-        for (int j = jr; j >= jl; --j) {
-            fd[i][j] = min(
-                fd[i+1][j] + 1, // insert
-                fd[i][j+1] + 1, // delete
-                fd[t1_rightmost[i]+1][t2_rightmost[j]+1] + td[i][j] // relabel
-            );
+
+    const char* value = std::getenv("TED_TILE_SIZE");
+
+    if (value != nullptr && std::atoi(value) > 0) {
+        b = std::atoi(value);
+    } else {
+        long cache = 256 * 1024;
+#ifdef _SC_LEVEL2_CACHE_SIZE
+        if (sysconf(_SC_LEVEL2_CACHE_SIZE) > 0) {
+            cache = sysconf(_SC_LEVEL2_CACHE_SIZE);
         }
+#endif
+        // A tile of fd and a tile of td in half of the cache, rounded down to whole cache lines of ints
+        b = static_cast<int>(std::sqrt(cache / 2.0 / (2 * sizeof(int)))) / 16 * 16;
+        b = std::max(b, 16);
     }
 
-    return fd;
+    tile.store(b, std::memory_order_relaxed);
+
+    return b;
+}
+
+void ZhangShasha::set_tile_size(int size) {
+    tile.store(std::max(size, 0), std::memory_order_relaxed);
 }
 
 int min(int a, int b, int c) {
     return std::min(std::min(a, b), c);
-}
\ No newline at end of file
+}
@@ -2,6 +2,12 @@
 #define ZHANGSHASHA_H
 
 #include <tree.h>
+#include <workspace.h>
+#include <preparedTree.h>
+#include <cancelToken.h>
+#include <checkpoint.h>
+#include <cstdint>
+#include <limits>
 
 namespace ZhangShasha {
     /**
@@ -9,7 +15,8 @@ namespace ZhangShasha {
      * programming algorithm described by ZhangShasha in 1989 in the paper 
      * Simple Fast Algorithms for the Editing Distance between Trees and Related Problems. 
      * 
-     * It requires O(n^4) time.
+     * It requires O(n^4) time. Trees of at most TinyTed::MAX_NODES nodes are compared by TinyTed without
+     * allocating anything.
      * 
      * @param t1 An ordered labeled rooted tree
      * @param t2 An ordered labeled rooted tree
@@ -19,6 +26,48 @@ namespace ZhangShasha {
     */
     int ted(const Tree& t1, const Tree& t2);
 
+    /**
+     * Computes the Tree Edit Distance (TED) between two prepared trees. The structural arrays of both trees are
+     * reused rather than derived again, and every table is taken from the given workspace. Tiny trees are
+     * compared by TinyTed instead.
+     * 
+     * @param t1 A prepared ordered labeled rooted tree
+     * @param t2 A prepared ordered labeled rooted tree
+     * @param ws The workspace that provides memory for this computation
+     * 
+     * @returns An integer that represents the number of operations needed to transform t1 into t2.
+     * Each operation has unit cost.
+    */
+    int ted(const PreparedTree& t1, const PreparedTree& t2, Workspace& ws);
+
+    /**
+     * Computes the Tree Edit Distance (TED) between T1 and T2 like ted does, but gives up as soon as the token
+     * expires. The token is checked between pairs of keyroots.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param token The token that tells when to stop
+     * 
+     * @returns The tree edit distance between t1 and t2, or -1 if the token expired first
+    */
+    int ted(const Tree& t1, const Tree& t2, const CancelToken& token);
+
+    /**
+     * Computes the Tree Edit Distance (TED) between T1 and T2 like ted does, but writes a checkpoint whenever one
+     * is due. It holds the table of tree edit distances, and the pairs of keyroots done so far, which are always
+     * those before the next one. If the schedule has a checkpoint to resume from, its table is restored and its
+     * pairs of keyroots are not computed again. Once the limit of the schedule is reached, a checkpoint is written
+     * and the computation stops.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param checkpoints The schedule of checkpoints. The checkpoint to resume from, if any, must have been
+     * written by this algorithm for the same trees
+     * 
+     * @returns The tree edit distance between t1 and t2, unless the computation stopped at the limit
+    */
+    int ted(const Tree& t1, const Tree& t2, Checkpoints& checkpoints);
+
     /**
      * Computes the Tree Edit Distance (TED) between T1 and T2 using the dynamic 
      * programming algorithm described by ZhangShasha in 1989 in the paper 
@@ -33,6 +82,36 @@ namespace ZhangShasha {
     */
     std::vector<std::vector<int>> ted_complete(const Tree& t1, const Tree& t2);
 
+    /**
+     * Computes the tree edit distance between every pair of subtrees of T1 and T2 like ted_complete does, but
+     * takes the table and every scratch buffer from the given workspace.
+     * 
+     * Every table is made of cells of the given type, which must be able to hold |T1| + |T2|. See with_cell.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param ws The workspace that provides memory for this computation
+     * 
+     * @returns A table where each tree edit distance between subtrees of T1 and T2 can be found. It remains
+     * valid until the caller releases it from the workspace.
+    */
+    template <typename Cell = int>
+    Workspace::Table<Cell> ted_complete(const Tree& t1, const Tree& t2, Workspace& ws);
+
+    /**
+     * Recomputes the tree edit distance between every node of T1 on the rightmost path of one of the given
+     * keyroots and every node of T2. Every other entry of td is assumed to hold the tree edit distance between
+     * its subtrees already, as it is read but never written.
+     * 
+     * It requires O(|T2|^2 * sum of the sizes of the given keyroots) time at most.
+     * 
+     * @param t1 An ordered labeled rooted tree
+     * @param t2 An ordered labeled rooted tree
+     * @param t1_keyroots Keyroots of T1 in decreasing order as given by keyroots_r
+     * @param td A table of size (|T1| + 1) x (|T2| + 1) that is updated with the new distances
+    */
+    void ted_partial(const Tree& t1, const Tree& t2, const std::vector<int>& t1_keyroots, std::vector<std::vector<int>>& td);
+
 
     /**
      * Computes the Forest Edit Distance (FED) between F1 and F2 using the dynamic
@@ -54,6 +133,23 @@ namespace ZhangShasha {
     */
     int fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td);
 
+    /**
+     * Computes the Forest Edit Distance (FED) between F1 and F2 like fed does, but only allocates a table that
+     * covers the ranges [il, ir] x [jl, jr] from the given workspace. The table is released before returning.
+     * 
+     * @param ws The workspace that provides memory for this computation
+    */
+    int fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td, Workspace& ws);
+
+    /**
+     * Computes the Forest Edit Distance (FED) between F1 and F2 given a table of tree edit distances that was
+     * obtained from a workspace. The forest distances use cells of the same type as td.
+     * 
+     * @param ws The workspace that provides memory for this computation
+    */
+    template <typename Cell>
+    int fed(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const Workspace::Table<Cell>& td, Workspace& ws);
+
     /**
      * Computes the Forest Edit Distance (FED) between F1 and F2 using the dynamic
      * programming algorithm described by ZhangShasha in 1989 in the paper
@@ -69,9 +165,52 @@ namespace ZhangShasha {
      * @param jr The index of the right node for partitioning T2 into F2
      * @param ted The tree edit distances between nodes of T1 and T2
      * 
+     * The table is made of cells of the same type as td, which must be able to hold |T1| + |T2|.
+     * 
      * @returns A table where each forest edit distance between subforests of F1 and F2 can be found.
     */  
-    std::vector<std::vector<int>> fed_complete(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<int>>& td);
+    template <typename Cell>
+    std::vector<std::vector<Cell>> fed_complete(const Tree& t1, int il, int ir, const Tree& t2, int jl, int jr, const std::vector<std::vector<Cell>>& td);
+
+    /**
+     * Calls fn with a value of the narrowest cell type that can hold every distance between two trees with
+     * n nodes in total. Distances never exceed the total number of nodes, so most pairs fit in 8 or 16 bits,
+     * which divides the memory and bandwidth used by the tables accordingly.
+     * 
+     * @param n The number of nodes in both trees
+     * @param fn A callable that takes a cell of type std::uint8_t, std::uint16_t or int
+     * 
+     * @returns The result of fn
+    */
+    template <typename F>
+    auto with_cell(int n, F&& fn) {
+        if (n <= std::numeric_limits<std::uint8_t>::max()) {
+            return fn(std::uint8_t());
+        }
+
+        if (n <= std::numeric_limits<std::uint16_t>::max()) {
+            return fn(std::uint16_t());
+        }
+
+        return fn(int());
+    }
+
+    /**
+     * Gets the side of the square tiles used to fill forest distance tables that do not fit in cache.
+     * 
+     * Unless it was set explicitly, it is read from the TED_TILE_SIZE environment variable, or otherwise derived
+     * from the size of the L2 cache so that a tile of fd and the matching tile of td fit in half of it.
+     * 
+     * @returns The number of rows and columns of a tile
+    */
+    int tile_size();
+
+    /**
+     * Sets the side of the square tiles used to fill forest distance tables that do not fit in cache.
+     * 
+     * @param size The number of rows and columns of a tile. If it is not positive, it is detected again
+    */
+    void set_tile_size(int size);
 }
 
 #endif
\ No newline at end of file
@@ -0,0 +1,318 @@
+#include <tree.h>
+#include <zhangShasha.h>
+#include <saeedSchemeOpt.h>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+/**
+ * Hardware performance counters for the calling thread, read through perf_event_open.
+ *
+ * When the counters cannot be opened, for instance because the kernel does not allow it or the platform is not
+ * Linux, only the elapsed time is measured.
+*/
+struct Counters {
+    // Names of the counters in the order they are opened
+    static constexpr const char* NAMES[] = {"cycles", "instructions", "cache_misses", "branch_misses"};
+    static const int COUNT = 4;
+
+    int fds[COUNT];
+    bool available;
+
+    Counters() {
+        available = false;
+        std::fill(fds, fds + COUNT, -1);
+
+#ifdef __linux__
+        const std::uint64_t configs[COUNT] = {
+            PERF_COUNT_HW_CPU_CYCLES,
+            PERF_COUNT_HW_INSTRUCTIONS,
+            PERF_COUNT_HW_CACHE_MISSES,
+            PERF_COUNT_HW_BRANCH_MISSES
+        };
+
+        for (int c = 0; c < COUNT; ++c) {
+            perf_event_attr attr;
+            std::memset(&attr, 0, sizeof(attr));
+            attr.size = sizeof(attr);
+            attr.type = PERF_TYPE_HARDWARE;
+            attr.config = configs[c];
+            attr.disabled = c == 0;
+            attr.exclude_kernel = 1;
+            attr.exclude_hv = 1;
+
+            // Every counter joins the group of the first one, so that they are enabled and disabled together
+            fds[c] = syscall(__NR_perf_event_open, &attr, 0, -1, c == 0 ? -1 : fds[0], 0);
+
+            if (fds[c] < 0) {
+                close_all();
+                return;
+            }
+        }
+
+        available = true;
+#endif
+    }
+
+    ~Counters() {
+        close_all();
+    }
+
+    void start() {
+#ifdef __linux__
+        if (available) {
+            ioctl(fds[0], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(fds[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+#endif
+    }
+
+    void stop(std::map<std::string, double>& values) {
+#ifdef __linux__
+        if (available) {
+            ioctl(fds[0], PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP);
+
+            for (int c = 0; c < COUNT; ++c) {
+                std::uint64_t value = 0;
+
+                if (read(fds[c], &value, sizeof(value)) == sizeof(value)) {
+                    values[NAMES[c]] = static_cast<double>(value);
+                }
+            }
+        }
+#endif
+    }
+
+private:
+    void close_all() {
+#ifdef __linux__
+        for (int c = 0; c < COUNT; ++c) {
+            if (fds[c] >= 0) {
+                close(fds[c]);
+                fds[c] = -1;
+            }
+        }
+#endif
+        available = false;
+    }
+};
+
+constexpr const char* Counters::NAMES[];
+
+/**
+ * Builds the pre-order traversal of a random tree where the parent of every node is any node before it, so the
+ * depth stays logarithmic. The same seed always gives the same tree.
+*/
+std::string random_tree(int n, int labels, unsigned seed) {
+    std::mt19937 random(seed);
+    std::vector<std::vector<int>> children(n + 1);
+
+    for (int u = 2; u <= n; ++u) {
+        children[std::uniform_int_distribution<int>(1, u - 1)(random)].push_back(u);
+    }
+
+    std::string pre_order;
+    std::vector<std::pair<int, int>> stack = {{1, 0}};
+
+    while (!stack.empty()) {
+        auto& [u, next] = stack.back();
+
+        if (next == 0) {
+            pre_order += std::to_string(std::uniform_int_distribution<int>(1, labels)(random)) + "(";
+        }
+
+        if (next < children[u].size()) {
+            int v = children[u][next++];
+            stack.push_back({v, 0});
+        } else {
+            pre_order += ")";
+            stack.pop_back();
+        }
+    }
+
+    return pre_order;
+}
+
+/**
+ * Runs a kernel several times and keeps the measurements of the fastest run.
+*/
+std::map<std::string, double> measure(Counters& counters, int repeat, const std::function<void()>& kernel) {
+    std::map<std::string, double> best;
+
+    for (int r = 0; r < repeat; ++r) {
+        std::map<std::string, double> values;
+
+        auto start = std::chrono::steady_clock::now();
+        counters.start();
+
+        kernel();
+
+        counters.stop(values);
+        auto stop = std::chrono::steady_clock::now();
+
+        values["time_ns"] = std::chrono::duration_cast<std::chrono::nanoseconds>(stop - start).count();
+
+        if (best.empty() || values["time_ns"] < best["time_ns"]) {
+            best = values;
+        }
+    }
+
+    return best;
+}
+
+/**
+ * Runs microbenchmarks for the main kernels and reports hardware counters for each one.
+ *
+ * Usage: bench [--repeat n] [--save file] [--baseline file] [--tolerance t]
+ *
+ * Results are printed as a table. With --save, they are written to a file with one line "kernel metric value"
+ * per measurement. With --baseline, they are compared against such a file, and every kernel whose cycles,
+ * instructions or time grew by more than the tolerance, 0.1 by default, is reported as a regression on the
+ * standard error. The exit code is 4 if there is any regression.
+*/
+int main(int argc, char *argv[]) {
+    int repeat = 5;
+    double tolerance = 0.1;
+    std::string save;
+    std::string baseline;
+
+    for (int i = 1; i + 1 < argc; i += 2) {
+        std::string option(argv[i]);
+
+        if (option == "--repeat") {
+            repeat = std::stoi(argv[i + 1]);
+        } else if (option == "--save") {
+            save = argv[i + 1];
+        } else if (option == "--baseline") {
+            baseline = argv[i + 1];
+        } else if (option == "--tolerance") {
+            tolerance = std::stod(argv[i + 1]);
+        } else {
+            std::cerr << "Usage: bench [--repeat n] [--save file] [--baseline file] [--tolerance t]" << std::endl;
+            return 1;
+        }
+    }
+
+    Counters counters;
+
+    if (!counters.available) {
+        std::cerr << "Hardware counters are not available, only time is measured" << std::endl;
+    }
+
+    std::string large = random_tree(200000, 50, 1);
+    Tree big(large);
+
+    Tree t1(random_tree(400, 10, 2));
+    Tree t2(random_tree(400, 10, 3));
+    std::vector<std::vector<int>> td = ZhangShasha::ted_complete(t1, t2);
+
+    Tree f1(random_tree(40, 5, 4));
+    Tree f2(random_tree(40, 5, 5));
+
+    // Results are kept alive here so that the compiler cannot drop the work
+    long long sink = 0;
+
+    std::vector<std::pair<std::string, std::function<void()>>> kernels = {
+        {"parse", [&]() { sink += Tree(large).n; }},
+        {"rightmost", [&]() { sink += big.rightmost()[1]; }},
+        {"keyroots_r", [&]() { sink += big.keyroots_r().size(); }},
+        {"ted_complete", [&]() { sink += ZhangShasha::ted_complete(t1, t2)[1][1]; }},
+        {"fed_complete", [&]() { sink += ZhangShasha::fed_complete(t1, 1, t1.n, t2, 1, t2.n, td)[1][1]; }},
+        {"fedds", [&]() { sink += SaeedSchemeOpt::FEDDS(f1, f2).query(1, f1.n, 1, f2.n); }},
+    };
+
+    const std::vector<std::string> metrics = {"time_ns", "cycles", "instructions", "cache_misses", "branch_misses"};
+
+    std::map<std::string, std::map<std::string, double>> results;
+
+    std::cout << std::left << std::setw(16) << "kernel";
+    for (const std::string& metric: metrics) {
+        std::cout << std::right << std::setw(16) << metric;
+    }
+    std::cout << std::endl;
+
+    for (const auto& [name, kernel]: kernels) {
+        results[name] = measure(counters, repeat, kernel);
+
+        std::cout << std::left << std::setw(16) << name;
+        for (const std::string& metric: metrics) {
+            auto it = results[name].find(metric);
+            std::cout << std::right << std::setw(16);
+
+            if (it == results[name].end()) {
+                std::cout << "-";
+            } else {
+                std::cout << std::fixed << std::setprecision(0) << it->second;
+            }
+        }
+        std::cout << std::endl;
+    }
+
+    if (!save.empty()) {
+        std::ofstream out(save);
+
+        for (const auto& [name, values]: results) {
+            for (const auto& [metric, value]: values) {
+                out << name << " " << metric << " " << std::fixed << std::setprecision(0) << value << "\n";
+            }
+        }
+    }
+
+    int regressions = 0;
+
+    if (!baseline.empty()) {
+        std::ifstream in(baseline);
+
+        if (!in) {
+            std::cerr << "Unable to read baseline " << baseline << std::endl;
+            return 2;
+        }
+
+        std::string line;
+        while (std::getline(in, line)) {
+            std::istringstream fields(line);
+            std::string name, metric;
+            double before;
+
+            if (!(fields >> name >> metric >> before) || before <= 0) {
+                continue;
+            }
+
+            if (metric != "cycles" && metric != "instructions" && metric != "time_ns") {
+                continue;
+            }
+
+            auto kernel = results.find(name);
+            if (kernel == results.end() || !kernel->second.count(metric)) {
+                continue;
+            }
+
+            double ratio = kernel->second[metric] / before;
+
+            if (ratio > 1 + tolerance) {
+                std::cerr << "Regression: " << name << " " << metric << " " << std::setprecision(2) << ratio << "x" << std::endl;
+                ++regressions;
+            }
+        }
+    }
+
+    std::cerr << "Checksum: " << sink << std::endl;
+
+    return regressions > 0 ? 4 : 0;
+}
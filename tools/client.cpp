@@ -0,0 +1,77 @@
+#include <protocol.h>
+#include <iostream>
+#include <string>
+
+#ifndef _WIN32
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+/**
+ * A client for the server mode of ted.exe, meant for testing.
+ * 
+ * Every line of the standard input is sent as a request and every response is printed on the standard output.
+ * 
+ * Usage:
+ * 
+ *      client <socket path>    Sends the requests to a server listening on a Unix domain socket
+ *      client --encode         Writes the requests as frames, so they can be piped into the server
+ *      client --decode         Reads frames written by the server and prints them as text
+*/
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        std::cerr << "Usage: client <socket path> | --encode | --decode" << std::endl;
+        return 1;
+    }
+
+    std::string mode(argv[1]);
+    std::string line;
+
+    if (mode == "--encode") {
+        while (std::getline(std::cin, line)) {
+            Protocol::write_frame(1, line);
+        }
+
+        return 0;
+    }
+
+    if (mode == "--decode") {
+        while (Protocol::read_frame(0, line)) {
+            std::cout << line << std::endl;
+        }
+
+        return 0;
+    }
+
+#ifdef _WIN32
+    std::cerr << "Unix domain sockets are not supported on this platform" << std::endl;
+    return 1;
+#else
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    mode.copy(address.sun_path, sizeof(address.sun_path) - 1);
+
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Unable to connect to " << mode << std::endl;
+        return 2;
+    }
+
+    while (std::getline(std::cin, line)) {
+        std::string response;
+
+        if (!Protocol::write_frame(fd, line) || !Protocol::read_frame(fd, response)) {
+            std::cerr << "Connection closed" << std::endl;
+            return 2;
+        }
+
+        std::cout << response << std::endl;
+    }
+
+    close(fd);
+
+    return 0;
+#endif
+}
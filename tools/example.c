@@ -0,0 +1,38 @@
+#include <cted.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+ * Compares two trees through the C interface of libted.
+ *
+ * Usage: ted-example <tree> <tree> [tau]
+ *
+ * Prints the tree edit distance between both trees and, when tau is given, whether it is at most tau.
+ */
+int main(int argc, char *argv[]) {
+    if (argc < 3) {
+        fprintf(stderr, "Usage: ted-example <tree> <tree> [tau]\n");
+        return 1;
+    }
+
+    ted_tree* t1 = ted_prepare(argv[1]);
+    ted_tree* t2 = ted_prepare(argv[2]);
+
+    if (t1 == NULL || t2 == NULL) {
+        fprintf(stderr, "Invalid tree\n");
+        ted_free(t1);
+        ted_free(t2);
+        return 2;
+    }
+
+    printf("%d\n", ted_distance(t1, t2));
+
+    if (argc >= 4) {
+        printf("%s\n", ted_within(t1, t2, atoi(argv[3])) == 1 ? "YES" : "NO");
+    }
+
+    ted_free(t1);
+    ted_free(t2);
+
+    return 0;
+}
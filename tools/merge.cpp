@@ -0,0 +1,133 @@
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <set>
+#include <sstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+/**
+ * Combines the outputs of the shards of a Join or AllPairs run of ted.exe into a single result.
+ *
+ * Every shard output must end with its "# shard i/N" line, and every shard from 0 to N - 1 must be present.
+ * Otherwise, the shards that are missing or did not finish are listed on the standard error so that they can
+ * be run again, and nothing is written to the standard output.
+ *
+ * Usage:
+ *
+ *      merge pairs <shard files...>        Prints the union of the "a b" lines of a join sorted by position
+ *      merge matrix <n> <shard files...>   Prints the n x n distance matrix from the "i j d" lines of all pairs
+*/
+int main(int argc, char *argv[]) {
+    std::string mode(argc >= 2 ? argv[1] : "");
+    int first = mode == "matrix" ? 3 : 2;
+
+    if ((mode != "pairs" && mode != "matrix") || argc <= first) {
+        std::cerr << "Usage: merge pairs <shard files...>" << std::endl;
+        std::cerr << "       merge matrix <n> <shard files...>" << std::endl;
+        return 1;
+    }
+
+    int n = mode == "matrix" ? std::stoi(argv[2]) : 0;
+
+    std::vector<std::pair<int, int>> pairs;
+    std::vector<std::vector<int>> matrix(n, std::vector<int>(n, -1));
+
+    int count = -1;
+    std::set<int> finished;
+    bool valid = true;
+
+    for (int f = first; f < argc; ++f) {
+        std::ifstream in(argv[f]);
+
+        if (!in) {
+            std::cerr << "Unable to read " << argv[f] << std::endl;
+            valid = false;
+            continue;
+        }
+
+        std::string line;
+        std::string trailer;
+
+        while (std::getline(in, line)) {
+            if (line.empty()) {
+                continue;
+            }
+
+            if (line[0] == '#') {
+                trailer = line;
+                continue;
+            }
+
+            std::istringstream values(line);
+            int a, b, d;
+
+            if (mode == "pairs" && values >> a >> b) {
+                pairs.push_back({a, b});
+            } else if (mode == "matrix" && values >> a >> b >> d && a >= 0 && b >= 0 && a < n && b < n) {
+                matrix[a][b] = matrix[b][a] = d;
+            } else {
+                std::cerr << "Malformed line in " << argv[f] << ": " << line << std::endl;
+                valid = false;
+            }
+        }
+
+        int index, total;
+        if (std::sscanf(trailer.c_str(), "# shard %d/%d", &index, &total) != 2) {
+            std::cerr << "Shard did not finish: " << argv[f] << std::endl;
+            valid = false;
+            continue;
+        }
+
+        if (count != -1 && count != total) {
+            std::cerr << "Shard " << argv[f] << " is out of " << total << " instead of " << count << std::endl;
+            valid = false;
+            continue;
+        }
+
+        count = total;
+        finished.insert(index);
+    }
+
+    for (int s = 0; s < count; ++s) {
+        if (!finished.count(s)) {
+            std::cerr << "Missing shard: " << s << "/" << count << std::endl;
+            valid = false;
+        }
+    }
+
+    for (int i = 0; i < n; ++i) {
+        matrix[i][i] = 0;
+
+        for (int j = i + 1; j < n; ++j) {
+            if (matrix[i][j] == -1) {
+                std::cerr << "Missing distance: " << i << " " << j << std::endl;
+                valid = false;
+                break;
+            }
+        }
+    }
+
+    if (!valid || count == -1) {
+        return 3;
+    }
+
+    if (mode == "pairs") {
+        std::sort(pairs.begin(), pairs.end());
+        pairs.erase(std::unique(pairs.begin(), pairs.end()), pairs.end());
+
+        for (const auto& p: pairs) {
+            std::cout << p.first << " " << p.second << "\n";
+        }
+    } else {
+        for (int i = 0; i < n; ++i) {
+            for (int j = 0; j < n; ++j) {
+                std::cout << matrix[i][j] << (j + 1 < n ? " " : "\n");
+            }
+        }
+    }
+
+    return 0;
+}